@@ -0,0 +1,57 @@
+#include "CommitPolicy.h"
+
+CommitPolicy::CommitPolicy(size_t maxBatchBytes, uint32_t maxDelayMs, uint32_t maxBatchWrites)
+    : maxBytes(maxBatchBytes), maxDelay(maxDelayMs), maxWrites(maxBatchWrites)
+{
+}
+
+bool CommitPolicy::onWrite(size_t bytes, uint32_t nowMs, bool highPriority)
+{
+  if (pending == 0)
+    batchStart = nowMs;
+  pending += bytes;
+  writes++;
+
+  if (highPriority)
+  {
+    lastReason = Reason::Priority;
+    return true;
+  }
+  if (pending >= maxBytes)
+  {
+    lastReason = Reason::Size;
+    return true;
+  }
+  if (maxWrites && writes >= maxWrites)
+  {
+    lastReason = Reason::Writes;
+    return true;
+  }
+  return due(nowMs);
+}
+
+bool CommitPolicy::due(uint32_t nowMs)
+{
+  if (pending == 0 || (uint32_t)(nowMs - batchStart) < maxDelay)
+    return false;
+  lastReason = Reason::Time;
+  return true;
+}
+
+void CommitPolicy::committed(uint32_t latencyUs, Reason why)
+{
+  if (pending == 0)
+    return;
+
+  counters.commits++;
+  counters.byReason[(int)why]++;
+  counters.bytesCommitted += pending;
+  if (pending > counters.maxBatchBytes)
+    counters.maxBatchBytes = pending;
+  counters.lastLatencyUs = latencyUs;
+  if (latencyUs > counters.maxLatencyUs)
+    counters.maxLatencyUs = latencyUs;
+  counters.totalLatencyUs += latencyUs;
+  pending = 0;
+  writes = 0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Decides when buffered history writes are committed (flushed and synced).
+ *
+ * Syncing every sample wrecks SD throughput and card life; never syncing
+ * risks losing hours of data on a power cut. Writes are grouped into a batch
+ * that is committed when any of these trips first:
+ * - size: the batch reaches maxBatchBytes
+ * - count: the batch holds maxBatchWrites writes (0 = no limit)
+ * - time: the oldest uncommitted write is maxDelayMs old
+ * - priority: a high-priority write (e.g. an alert) arrives
+ *
+ * The policy only decides; FileManager performs the commit and reports its
+ * latency back through committed().
+ */
+class CommitPolicy
+{
+public:
+  enum class Reason : uint8_t
+  {
+    Size,
+    Writes,
+    Time,
+    Priority,
+    Explicit,
+    Read, // A history read needed records that were still buffered
+    Count
+  };
+
+  struct Stats
+  {
+    uint32_t commits = 0;
+    uint32_t byReason[(int)Reason::Count] = {};
+    uint32_t bytesCommitted = 0;
+    uint32_t maxBatchBytes = 0;
+    uint32_t lastLatencyUs = 0;
+    uint32_t maxLatencyUs = 0;
+    uint64_t totalLatencyUs = 0;
+
+    uint32_t avgBytesPerCommit() const { return commits ? bytesCommitted / commits : 0; }
+    uint32_t avgLatencyUs() const { return commits ? (uint32_t)(totalLatencyUs / commits) : 0; }
+  };
+
+  explicit CommitPolicy(size_t maxBatchBytes = 4096, uint32_t maxDelayMs = 60000, uint32_t maxBatchWrites = 0);
+
+  void setMaxBatchBytes(size_t bytes) { maxBytes = bytes; }
+  void setMaxBatchWrites(uint32_t writes) { maxWrites = writes; }
+  void setMaxDelayMs(uint32_t ms) { maxDelay = ms; }
+
+  // Account for a write into the current batch; returns true if it should be committed now
+  bool onWrite(size_t bytes, uint32_t nowMs, bool highPriority = false);
+  // Time threshold check for when no writes arrive; returns true if a commit is due
+  bool due(uint32_t nowMs);
+  // Reason behind the last true from onWrite()/due()
+  Reason reason() const { return lastReason; }
+
+  // Record a finished commit and start a new batch
+  void committed(uint32_t latencyUs, Reason why);
+  void committed(uint32_t latencyUs) { committed(latencyUs, lastReason); }
+
+  size_t pendingBytes() const { return pending; }
+  uint32_t pendingWrites() const { return writes; }
+  const Stats &stats() const { return counters; }
+  void resetStats() { counters = Stats(); }
+
+private:
+  size_t maxBytes;
+  uint32_t maxDelay;
+  uint32_t maxWrites;
+  size_t pending = 0;
+  uint32_t writes = 0;
+  uint32_t batchStart = 0;
+  Reason lastReason = Reason::Explicit;
+  Stats counters;
+};
@@ -0,0 +1,211 @@
+#include "DigitDisplay.h"
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+  const uint32_t LETTERS[DigitAtlas::GLYPH_COUNT] = {
+      '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+      '.', '-', '+', '%', 'C', 0xB0 /* ° */, ' '};
+  const uint8_t SPACE = DigitAtlas::GLYPH_COUNT - 1;
+
+  // Coverage of pixel i of a packed 1/2/4/8 bpp LVGL glyph bitmap, as 0..255
+  uint8_t coverage(const uint8_t *bitmap, uint32_t i, uint8_t bpp)
+  {
+    uint32_t bit = i * bpp;
+    uint8_t value = (bitmap[bit >> 3] >> (8 - bpp - (bit & 7))) & ((1 << bpp) - 1);
+    return (uint8_t)(value * 255 / ((1 << bpp) - 1));
+  }
+}
+
+DigitAtlas::~DigitAtlas()
+{
+  free(data);
+}
+
+bool DigitAtlas::build(const lv_font_t *font, lv_color_t fg, lv_color_t background)
+{
+  free(data);
+  data = nullptr;
+  bg = background;
+  cellHeight = (uint16_t)lv_font_get_line_height(font);
+  maxCellWidth = 0;
+
+  totalPixels = 0;
+  for (uint8_t g = 0; g < GLYPH_COUNT; g++)
+  {
+    offsets[g] = (uint32_t)totalPixels;
+    widths[g] = (uint16_t)lv_font_get_glyph_width(font, LETTERS[g], 0);
+    if (widths[g] > maxCellWidth)
+      maxCellWidth = widths[g];
+    totalPixels += (size_t)widths[g] * cellHeight;
+  }
+
+  // System heap rather than LVGL's pool: a 28 px atlas is around 18 KB
+  data = (lv_color_t *)malloc(bytes());
+  if (!data)
+    return false;
+
+  for (uint8_t g = 0; g < GLYPH_COUNT; g++)
+  {
+    lv_color_t *cell = data + offsets[g];
+    for (size_t i = 0; i < (size_t)widths[g] * cellHeight; i++)
+      cell[i] = bg;
+
+    lv_font_glyph_dsc_t dsc;
+    if (!lv_font_get_glyph_dsc(font, &dsc, LETTERS[g], 0) || dsc.box_w == 0)
+      continue;
+    const uint8_t *bitmap = lv_font_get_glyph_bitmap(font, LETTERS[g]);
+    if (!bitmap)
+      continue;
+
+    // Same placement as lv_draw_letter: ofs_y is measured up from the baseline
+    int32_t top = (int32_t)font->line_height - font->base_line - dsc.box_h - dsc.ofs_y;
+    for (uint16_t y = 0; y < dsc.box_h; y++)
+    {
+      int32_t cy = top + y;
+      if (cy < 0 || cy >= cellHeight)
+        continue;
+      for (uint16_t x = 0; x < dsc.box_w; x++)
+      {
+        int32_t cx = dsc.ofs_x + x;
+        if (cx < 0 || cx >= widths[g])
+          continue;
+        uint8_t a = coverage(bitmap, (uint32_t)y * dsc.box_w + x, dsc.bpp);
+        cell[cy * widths[g] + cx] = lv_color_mix(fg, bg, a);
+      }
+    }
+  }
+  return true;
+}
+
+uint8_t DigitAtlas::glyphFor(uint32_t letter) const
+{
+  for (uint8_t g = 0; g < GLYPH_COUNT; g++)
+    if (LETTERS[g] == letter)
+      return g;
+  return SPACE;
+}
+
+lv_obj_t *DigitDisplay::create(lv_obj_t *parent, const DigitAtlas &digitAtlas, uint8_t maxChars)
+{
+  atlas = &digitAtlas;
+  length = 0;
+  if (maxChars > MAX_CHARS)
+    maxChars = MAX_CHARS;
+
+  // A bare object: no theme styles, everything is drawn by drawEvent()
+  object = lv_obj_create(parent);
+  lv_obj_remove_style_all(object);
+  lv_obj_clear_flag(object, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_clear_flag(object, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_size(object, atlas->maxWidth() * maxChars, atlas->height());
+  lv_obj_add_event_cb(object, drawEvent, LV_EVENT_DRAW_MAIN, this);
+  return object;
+}
+
+void DigitDisplay::setText(const char *text)
+{
+  uint8_t next[MAX_CHARS];
+  uint8_t nextLength = 0;
+  for (const char *p = text; *p && nextLength < MAX_CHARS;)
+  {
+    uint32_t letter = _lv_txt_encoded_next(p, nullptr);
+    p += _lv_txt_encoded_size(p);
+    next[nextLength++] = atlas->glyphFor(letter);
+  }
+
+  // Walk both strings while glyph positions still line up; a changed glyph
+  // of the same width only dirties its own cell, anything that shifts the
+  // rest of the line dirties everything from there to the longer end
+  lv_area_t coords;
+  lv_obj_get_coords(object, &coords);
+  uint16_t oldEnd = textWidth();
+  uint16_t x = 0;
+  uint8_t count = length > nextLength ? length : nextLength;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    uint8_t before = i < length ? glyphs[i] : DigitAtlas::NO_GLYPH;
+    uint8_t after = i < nextLength ? next[i] : DigitAtlas::NO_GLYPH;
+    uint16_t w = atlas->width(after);
+    if (before == after)
+    {
+      x += w;
+      continue;
+    }
+
+    lv_area_t dirty = coords;
+    dirty.x1 = coords.x1 + x;
+    if (atlas->width(before) == w)
+    {
+      dirty.x2 = dirty.x1 + w - 1;
+      lv_obj_invalidate_area(object, &dirty);
+      x += w;
+      continue;
+    }
+
+    uint16_t newEnd = x;
+    for (uint8_t j = i; j < nextLength; j++)
+      newEnd += atlas->width(next[j]);
+    dirty.x2 = coords.x1 + (oldEnd > newEnd ? oldEnd : newEnd) - 1;
+    lv_obj_invalidate_area(object, &dirty);
+    break;
+  }
+
+  memcpy(glyphs, next, nextLength);
+  length = nextLength;
+}
+
+uint16_t DigitDisplay::textWidth() const
+{
+  uint16_t w = 0;
+  for (uint8_t i = 0; i < length; i++)
+    w += atlas->width(glyphs[i]);
+  return w;
+}
+
+void DigitDisplay::drawEvent(lv_event_t *e)
+{
+  auto *self = (DigitDisplay *)lv_event_get_user_data(e);
+  self->draw(lv_event_get_draw_ctx(e));
+}
+
+void DigitDisplay::draw(lv_draw_ctx_t *drawCtx) const
+{
+  lv_area_t coords;
+  lv_obj_get_coords(object, &coords);
+  lv_area_t clip;
+  if (!_lv_area_intersect(&clip, &coords, drawCtx->clip_area))
+    return;
+
+  lv_color_t *buf = (lv_color_t *)drawCtx->buf;
+  const lv_area_t *bufArea = drawCtx->buf_area;
+  lv_coord_t stride = lv_area_get_width(bufArea);
+
+  for (lv_coord_t y = clip.y1; y <= clip.y2; y++)
+  {
+    lv_color_t *dst = buf + (int32_t)(y - bufArea->y1) * stride - bufArea->x1;
+    lv_coord_t row = y - coords.y1;
+    lv_coord_t x = coords.x1;
+    for (uint8_t i = 0; i <= length && x <= clip.x2; i++)
+    {
+      if (i == length)
+      {
+        // Background after the text up to the widget's right edge
+        for (lv_coord_t px = x > clip.x1 ? x : clip.x1; px <= clip.x2; px++)
+          dst[px] = atlas->background();
+        break;
+      }
+
+      uint16_t w = atlas->width(glyphs[i]);
+      lv_coord_t from = x > clip.x1 ? x : clip.x1;
+      lv_coord_t to = x + w - 1 < clip.x2 ? x + w - 1 : clip.x2;
+      if (from <= to)
+      {
+        const lv_color_t *src = atlas->pixels(glyphs[i]) + (int32_t)row * w + (from - x);
+        memcpy(dst + from, src, (size_t)(to - from + 1) * sizeof(lv_color_t));
+      }
+      x += w;
+    }
+  }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <lvgl.h>
+#include <stdint.h>
+
+/**
+ * Glyphs for numeric readouts, rasterised once into RGB565 (lv_color_t).
+ *
+ * Covers digits, '.', '-', '+', '%', 'C', '°' and space. Each glyph is
+ * pre-blended with the given foreground over the background colour, so
+ * drawing one is a plain row copy with no anti-aliasing work. One atlas
+ * can be shared by any number of DigitDisplays using the same font and
+ * colours.
+ */
+class DigitAtlas
+{
+public:
+  static const uint8_t GLYPH_COUNT = 17;
+  static const uint8_t NO_GLYPH = 0xFF;
+
+  DigitAtlas() = default;
+  DigitAtlas(const DigitAtlas &) = delete;
+  DigitAtlas &operator=(const DigitAtlas &) = delete;
+  ~DigitAtlas();
+
+  // Rasterise the glyph set; false if the atlas could not be allocated
+  bool build(const lv_font_t *font, lv_color_t fg, lv_color_t bg);
+
+  // Glyph index for a Unicode code point (unsupported characters show as space)
+  uint8_t glyphFor(uint32_t letter) const;
+  uint16_t width(uint8_t glyph) const { return glyph < GLYPH_COUNT ? widths[glyph] : 0; }
+  uint16_t height() const { return cellHeight; }
+  uint16_t maxWidth() const { return maxCellWidth; }
+  lv_color_t background() const { return bg; }
+  // First pixel of a glyph; rows are width(glyph) pixels apart
+  const lv_color_t *pixels(uint8_t glyph) const { return data + offsets[glyph]; }
+  size_t bytes() const { return totalPixels * sizeof(lv_color_t); }
+
+private:
+  lv_color_t *data = nullptr;
+  size_t totalPixels = 0;
+  uint32_t offsets[GLYPH_COUNT] = {};
+  uint16_t widths[GLYPH_COUNT] = {};
+  uint16_t cellHeight = 0;
+  uint16_t maxCellWidth = 0;
+  lv_color_t bg;
+};
+
+/**
+ * Single-line numeric readout drawn from a DigitAtlas.
+ *
+ * setText() compares the new value with the one on screen and invalidates
+ * only the glyphs that changed (or moved), so "21.5" -> "21.6" redraws and
+ * flushes one glyph-sized rectangle instead of a whole label.
+ *
+ * The glyphs are copied straight into LVGL's draw buffer, so the widget
+ * must not be drawn with opacity or transforms.
+ */
+class DigitDisplay
+{
+public:
+  static const uint8_t MAX_CHARS = 12;
+
+  // Creates the object sized for maxChars of the widest glyph
+  lv_obj_t *create(lv_obj_t *parent, const DigitAtlas &atlas, uint8_t maxChars);
+  // UTF-8 text; characters outside the atlas are shown as spaces
+  void setText(const char *text);
+  lv_obj_t *obj() const { return object; }
+
+private:
+  static void drawEvent(lv_event_t *e);
+  void draw(lv_draw_ctx_t *drawCtx) const;
+  uint16_t textWidth() const;
+
+  const DigitAtlas *atlas = nullptr;
+  lv_obj_t *object = nullptr;
+  uint8_t glyphs[MAX_CHARS];
+  uint8_t length = 0;
+};
@@ -0,0 +1,122 @@
+#include "DisplayBenchmark.h"
+
+namespace
+{
+  struct BufferConfig
+  {
+    uint16_t lines;
+    uint8_t count;
+  };
+
+  const BufferConfig CONFIGS[] = {
+      {10, 1}, {10, 2}, {20, 1}, {20, 2}, {40, 1}, {40, 2}, {80, 1}, {80, 2}};
+}
+
+void DisplayBenchmark::run(TemplateCode &display, uint16_t iterations)
+{
+  uint16_t origLines = display.drawBufferLines();
+  uint8_t origCount = display.drawBufferCount();
+  lv_obj_t *prevScreen = lv_scr_act();
+
+  lv_obj_t *valueLabel = nullptr;
+  lv_obj_t *screen = createScreen(&valueLabel);
+  lv_scr_load(screen);
+
+  Serial.printf("Display benchmark %ux%u, %u-bit colour, %u frames per test\n",
+                (unsigned)display.screenWidth(), (unsigned)display.screenHeight(), (unsigned)LV_COLOR_DEPTH,
+                (unsigned)iterations);
+  if (display.expandBufferBytes())
+    Serial.printf("RGB565 expansion buffers: %u bytes\n", (unsigned)display.expandBufferBytes());
+  for (const BufferConfig &cfg : CONFIGS)
+  {
+    if (!display.setDrawBuffers(cfg.lines, cfg.count))
+      continue;
+    // Configs that did not fit were shrunk by setDrawBuffers(); report what was actually used
+    Serial.printf("lines=%3u bufs=%u bytes=%6u ", (unsigned)display.drawBufferLines(),
+                  (unsigned)display.drawBufferCount(), (unsigned)display.drawBufferBytes());
+    printFps("full", timeFull(display, iterations));
+    printFps("partial", timePartial(display, valueLabel, iterations));
+    printSplit(display, iterations);
+    Serial.println();
+  }
+
+  display.setDrawBuffers(origLines, origCount);
+  lv_scr_load(prevScreen);
+  lv_obj_del(screen);
+}
+
+lv_obj_t *DisplayBenchmark::createScreen(lv_obj_t **valueLabel)
+{
+  // Representative content: gradient background, text and a bar
+  lv_obj_t *screen = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(screen, lv_color_hex(0x000000), LV_PART_MAIN);
+  lv_obj_set_style_bg_grad_color(screen, lv_color_hex(0x1E3A5F), LV_PART_MAIN);
+  lv_obj_set_style_bg_grad_dir(screen, LV_GRAD_DIR_VER, LV_PART_MAIN);
+
+  lv_obj_t *title = lv_label_create(screen);
+  lv_label_set_text(title, "Display benchmark");
+  lv_obj_set_style_text_color(title, lv_color_hex(0xFFFFFF), LV_PART_MAIN);
+  lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
+
+  lv_obj_t *value = lv_label_create(screen);
+  lv_obj_set_style_text_font(value, &lv_font_montserrat_28, 0);
+  lv_obj_set_style_text_color(value, lv_color_hex(0xFFFFFF), LV_PART_MAIN);
+  lv_label_set_text(value, "00.0");
+  lv_obj_align(value, LV_ALIGN_CENTER, 0, 0);
+
+  lv_obj_t *bar = lv_bar_create(screen);
+  lv_obj_set_size(bar, 200, 16);
+  lv_bar_set_value(bar, 60, LV_ANIM_OFF);
+  lv_obj_align(bar, LV_ALIGN_BOTTOM_MID, 0, -20);
+
+  *valueLabel = value;
+  return screen;
+}
+
+uint32_t DisplayBenchmark::timeFull(TemplateCode &display, uint16_t iterations)
+{
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < iterations; i++)
+  {
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(nullptr);
+  }
+  display.waitForFlush();
+  return (micros() - start) / iterations;
+}
+
+uint32_t DisplayBenchmark::timePartial(TemplateCode &display, lv_obj_t *label, uint16_t iterations)
+{
+  char text[8];
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < iterations; i++)
+  {
+    text[0] = (char)('0' + (i / 100) % 10);
+    text[1] = (char)('0' + (i / 10) % 10);
+    text[2] = '.';
+    text[3] = (char)('0' + i % 10);
+    text[4] = '\0';
+    lv_label_set_text(label, text);
+    lv_refr_now(nullptr);
+  }
+  display.waitForFlush();
+  return (micros() - start) / iterations;
+}
+
+void DisplayBenchmark::printSplit(TemplateCode &display, uint16_t iterations)
+{
+  // One frame at a time, so each frame's render and flush are attributed cleanly
+  display.resetRenderStats();
+  for (uint16_t i = 0; i < iterations; i++)
+    display.measureFullRedraw();
+  const RenderStats &stats = display.renderStats();
+  Serial.printf("render=%5lu us flush=%5lu us ", (unsigned long)stats.renderUs().mean(),
+                (unsigned long)stats.flushUs().mean());
+}
+
+void DisplayBenchmark::printFps(const char *name, uint32_t usPerFrame)
+{
+  uint32_t fps10 = usPerFrame ? 10000000UL / usPerFrame : 0;
+  Serial.printf("%s=%5lu us (%3lu.%lu fps) ", name, (unsigned long)usPerFrame,
+                (unsigned long)(fps10 / 10), (unsigned long)(fps10 % 10));
+}
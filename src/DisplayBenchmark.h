@@ -0,0 +1,33 @@
+#pragma once
+
+#include <lvgl.h>
+#include "TemplateCode.h"
+
+/**
+ * Built-in display throughput benchmark.
+ *
+ * Shows a test screen and, for each draw-buffer configuration (stripe lines
+ * x buffer count), measures:
+ * - full redraw: whole screen invalidated, rendered and flushed
+ * - partial redraw: one small numeric label changed, as on a sensor update
+ * - render/flush split: mean CPU render time and transfer time of a full
+ *   redraw, one frame at a time
+ *
+ * Results go to Serial as a table so the memory/FPS trade-off can be picked
+ * per board variant. The original buffers and screen are restored afterwards.
+ * Enable with -DRUN_DISPLAY_BENCHMARK in platformio.ini, or run
+ * `program --benchmark` on the host build. To compare colour depths, run it
+ * once with and once without -DLVGL_COLOR_8BIT=1.
+ */
+class DisplayBenchmark
+{
+public:
+  static void run(TemplateCode &display, uint16_t iterations = 20);
+
+private:
+  static lv_obj_t *createScreen(lv_obj_t **valueLabel);
+  static uint32_t timeFull(TemplateCode &display, uint16_t iterations);
+  static uint32_t timePartial(TemplateCode &display, lv_obj_t *label, uint16_t iterations);
+  static void printSplit(TemplateCode &display, uint16_t iterations);
+  static void printFps(const char *name, uint32_t usPerFrame);
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Display hardware abstraction used by TemplateCode for LVGL flushing.
+ *
+ * Exactly one backend is compiled in (see PanelDisplay.h), selected by build flag:
+ * - (default)                  TftEspiDisplay  - TFT_eSPI, optional SPI DMA
+ * - DISPLAY_BACKEND_LOVYANGFX  LovyanDisplay   - LovyanGFX, SPI DMA
+ * - host builds (no ARDUINO)   HostDisplay     - in-memory RGB565 framebuffer
+ *
+ * The panel is initialised once, by one driver stack, through this interface.
+ * Nothing else in the firmware should talk to the display controller directly.
+ */
+
+// Flush over SPI DMA with two draw buffers so LVGL renders the next stripe
+// while the previous one is clocked out. Set to 0 for blocking transfers
+// with a single draw buffer (useful for before/after timing).
+#ifndef LVGL_DMA_FLUSH
+#define LVGL_DMA_FLUSH 1
+#endif
+
+class DisplayHAL
+{
+public:
+  virtual ~DisplayHAL() = default;
+
+  // Initialise the panel once. swapBytes: pixels arrive in host byte order
+  // and must be swapped to the panel's big-endian RGB565 on the way out.
+  virtual bool begin(uint8_t rotation, bool swapBytes) = 0;
+  virtual void setRotation(uint8_t rotation) = 0;
+
+  // Start sending a w x h block of RGB565 pixels at (x, y). May return while
+  // the transfer is still running; pixels must stay valid until it is done.
+  // Pushing again while a transfer is running waits for that one first.
+  virtual void pushPixels(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *pixels) = 0;
+  // Non-blocking: true (and the bus released) once the last push has completed
+  virtual bool transferDone() = 0;
+  // Block until the last push has completed and release the bus
+  virtual void waitTransfer() = 0;
+};
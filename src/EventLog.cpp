@@ -0,0 +1,136 @@
+#include "EventLog.h"
+#include <stdio.h>
+#include <string.h>
+#include "FixedFormat.h"
+
+void EventLog::raise(EventType type, uint32_t timestamp, int16_t value)
+{
+  events[total % EVENT_LOG_CAPACITY] = {timestamp, value, type};
+  total++;
+}
+
+bool EventLog::observe(const LogRecord &rec)
+{
+  if (isLogRecordEmpty(rec))
+    return false;
+  bool urgent = false;
+  if (primed && rec.timestamp < lastTimestamp)
+  {
+    raise(EventType::Restart, rec.timestamp, 0);
+    urgent = true;
+  }
+  primed = true;
+  lastTimestamp = rec.timestamp;
+
+  bool valid = rec.temperature != LOG_TEMP_INVALID && rec.humidity != LOG_HUMIDITY_INVALID;
+  if (!valid)
+  {
+    if (sensorOk)
+    {
+      raise(EventType::SensorFault, rec.timestamp, 0);
+      urgent = true;
+    }
+    sensorOk = false;
+    return urgent;
+  }
+  if (!sensorOk)
+    raise(EventType::SensorRecovered, rec.timestamp, 0);
+  sensorOk = true;
+
+  int16_t t = rec.temperature;
+  if (temp != Level::High && t >= ALERT_TEMP_HIGH)
+  {
+    temp = Level::High;
+    raise(EventType::TempHigh, rec.timestamp, t);
+    urgent = true;
+  }
+  else if (temp != Level::Low && t <= ALERT_TEMP_LOW)
+  {
+    temp = Level::Low;
+    raise(EventType::TempLow, rec.timestamp, t);
+    urgent = true;
+  }
+  else if ((temp == Level::High && t < ALERT_TEMP_HIGH - ALERT_HYSTERESIS) ||
+           (temp == Level::Low && t > ALERT_TEMP_LOW + ALERT_HYSTERESIS))
+  {
+    temp = Level::Normal;
+    raise(EventType::TempNormal, rec.timestamp, t);
+  }
+
+  int16_t h = (int16_t)rec.humidity;
+  if (humidity == Level::Normal && h >= ALERT_HUMIDITY_HIGH)
+  {
+    humidity = Level::High;
+    raise(EventType::HumidityHigh, rec.timestamp, h);
+    urgent = true;
+  }
+  else if (humidity == Level::High && h < ALERT_HUMIDITY_HIGH - ALERT_HYSTERESIS)
+  {
+    humidity = Level::Normal;
+    raise(EventType::HumidityNormal, rec.timestamp, h);
+  }
+  return urgent;
+}
+
+bool EventLog::get(uint32_t newest, Event &out) const
+{
+  if (newest >= count())
+    return false;
+  out = events[(total - 1 - newest) % EVENT_LOG_CAPACITY];
+  return true;
+}
+
+size_t EventLog::format(const Event &event, char *buf, size_t size)
+{
+  const char *text = "";
+  const char *unit = "";
+  switch (event.type)
+  {
+  case EventType::Restart:
+    text = "Restarted";
+    break;
+  case EventType::SensorFault:
+    text = "Sensor read failed";
+    break;
+  case EventType::SensorRecovered:
+    text = "Sensor reading again";
+    break;
+  case EventType::TempHigh:
+    text = "Temperature high ";
+    unit = "°C";
+    break;
+  case EventType::TempLow:
+    text = "Temperature low ";
+    unit = "°C";
+    break;
+  case EventType::TempNormal:
+    text = "Temperature normal ";
+    unit = "°C";
+    break;
+  case EventType::HumidityHigh:
+    text = "Humidity high ";
+    unit = "%";
+    break;
+  case EventType::HumidityNormal:
+    text = "Humidity normal ";
+    unit = "%";
+    break;
+  }
+
+  uint32_t s = event.timestamp;
+  int n = snprintf(buf, size, "%lud %02u:%02u  %s", (unsigned long)(s / 86400), (unsigned)(s / 3600 % 24),
+                   (unsigned)(s / 60 % 60), text);
+  if (n < 0 || (size_t)n >= size || !*unit)
+    return n < 0 ? 0 : ((size_t)n < size ? (size_t)n : size - 1);
+
+  // Value and unit without the float printf path
+  char value[FIXED_MAX_LEN + 4];
+  char *end = writeFixed(value, event.value, 1);
+  size_t unitLen = strlen(unit);
+  if ((size_t)n + (end - value) + unitLen >= size)
+    return (size_t)n;
+  memcpy(buf + n, value, end - value);
+  n += end - value;
+  memcpy(buf + n, unit, unitLen + 1);
+  return (size_t)n + unitLen;
+}
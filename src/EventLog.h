@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "LogRecord.h"
+
+// Events kept in RAM (8 bytes each); the oldest are dropped beyond this
+#ifndef EVENT_LOG_CAPACITY
+#define EVENT_LOG_CAPACITY 2048
+#endif
+// Alert thresholds in tenths (LogRecord units); an alert clears once the value
+// is back inside the limit by ALERT_HYSTERESIS
+#ifndef ALERT_TEMP_HIGH
+#define ALERT_TEMP_HIGH 300
+#endif
+#ifndef ALERT_TEMP_LOW
+#define ALERT_TEMP_LOW 50
+#endif
+#ifndef ALERT_HUMIDITY_HIGH
+#define ALERT_HUMIDITY_HIGH 800
+#endif
+#ifndef ALERT_HYSTERESIS
+#define ALERT_HYSTERESIS 5
+#endif
+
+enum class EventType : uint8_t
+{
+  Restart,
+  SensorFault,
+  SensorRecovered,
+  TempHigh,
+  TempLow,
+  TempNormal,
+  HumidityHigh,
+  HumidityNormal
+};
+
+struct Event
+{
+  uint32_t timestamp; // of the record that raised it
+  int16_t value;      // reading in tenths, where the event has one
+  EventType type;
+};
+
+/**
+ * Alerts, sensor faults and restarts, derived from the logged readings.
+ *
+ * observe() is fed every record in log order, from storage at startup and
+ * then as each one is logged, so the event list covers stored history
+ * without a second on-disk format. A restart shows up as a timestamp going
+ * backwards (timestamps are seconds since boot).
+ *
+ * Events live in a fixed ring of EVENT_LOG_CAPACITY; index 0 is the newest.
+ * Not locked: feed and read it from the loop task.
+ */
+class EventLog
+{
+public:
+  // True if rec raised an alert, a sensor fault or a restart, which the
+  // caller should persist right away (FileManager::appendRecord highPriority)
+  bool observe(const LogRecord &rec);
+
+  // Events held, at most EVENT_LOG_CAPACITY
+  uint32_t count() const { return total < EVENT_LOG_CAPACITY ? total : EVENT_LOG_CAPACITY; }
+  // Events raised so far, including dropped ones; grows by one per event
+  uint32_t raised() const { return total; }
+  // newest = 0 is the latest event; false past count()
+  bool get(uint32_t newest, Event &out) const;
+
+  // "2d 04:13  Temperature high 31.2°C"; returns the length written
+  static size_t format(const Event &event, char *buf, size_t size);
+
+private:
+  enum class Level : uint8_t
+  {
+    Normal,
+    High,
+    Low
+  };
+
+  void raise(EventType type, uint32_t timestamp, int16_t value);
+
+  Event events[EVENT_LOG_CAPACITY];
+  uint32_t total = 0;
+
+  bool primed = false;
+  bool sensorOk = true;
+  Level temp = Level::Normal;
+  Level humidity = Level::Normal;
+  uint32_t lastTimestamp = 0;
+};
@@ -0,0 +1,87 @@
+#include "EventScreen.h"
+#include "Theme.h"
+
+lv_obj_t *EventScreen::build()
+{
+  screen = lv_obj_create(NULL);
+  lv_obj_add_style(screen, Theme::screen(), 0);
+  lv_obj_add_style(screen, Theme::spacing(), 0);
+  lv_obj_clear_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_layout(screen, LV_LAYOUT_FLEX);
+  lv_obj_set_flex_flow(screen, LV_FLEX_FLOW_COLUMN);
+
+  // Toolbar: back, title with the event count
+  lv_obj_t *bar = lv_obj_create(screen);
+  lv_obj_set_size(bar, lv_pct(100), LV_SIZE_CONTENT);
+  lv_obj_add_style(bar, Theme::bare(), 0);
+  lv_obj_clear_flag(bar, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_layout(bar, LV_LAYOUT_FLEX);
+  lv_obj_set_flex_flow(bar, LV_FLEX_FLOW_ROW);
+  lv_obj_set_flex_align(bar, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+
+  lv_obj_t *back = lv_btn_create(bar);
+  lv_obj_set_size(back, 40, 32);
+  lv_obj_add_event_cb(back, onBack, LV_EVENT_CLICKED, this);
+  lv_obj_t *backLabel = lv_label_create(back);
+  lv_label_set_text(backLabel, LV_SYMBOL_LEFT);
+  lv_obj_center(backLabel);
+
+  title = lv_label_create(bar);
+  lv_obj_set_flex_grow(title, 1);
+  lv_obj_add_style(title, Theme::text(), 0);
+  lv_label_set_text(title, "Events");
+
+  rows.create(screen, fetch, this);
+  lv_obj_set_width(rows.object(), lv_pct(100));
+  lv_obj_set_flex_grow(rows.object(), 1);
+  return screen;
+}
+
+void EventScreen::released()
+{
+  rows.released();
+  screen = title = nullptr;
+}
+
+void EventScreen::show(EventLog &source)
+{
+  log = &source;
+  if (!screen)
+    return;
+  shown = log->raised();
+  rows.setCount(log->count());
+  updateTitle();
+}
+
+void EventScreen::update()
+{
+  if (!screen || !log || log->raised() == shown)
+    return;
+  uint32_t added = log->raised() - shown;
+  shown = log->raised();
+  rows.setCount(log->count(), added);
+  updateTitle();
+}
+
+void EventScreen::updateTitle()
+{
+  if (log->count())
+    lv_label_set_text_fmt(title, "Events (%lu)", (unsigned long)log->count());
+  else
+    lv_label_set_text(title, "Events (none yet)");
+}
+
+void EventScreen::fetch(uint32_t index, char *text, size_t size, void *context)
+{
+  auto *self = static_cast<EventScreen *>(context);
+  Event event;
+  if (self->log && self->log->get(index, event))
+    EventLog::format(event, text, size);
+  else if (size)
+    text[0] = '\0';
+}
+
+void EventScreen::onBack(lv_event_t *e)
+{
+  static_cast<EventScreen *>(lv_event_get_user_data(e))->screens.back();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <lvgl.h>
+#include "EventLog.h"
+#include "ScreenManager.h"
+#include "VirtualList.h"
+
+/**
+ * Alerts, sensor faults and restarts, newest first.
+ *
+ * The list is a VirtualList, so the screen costs the same with ten events
+ * or EVENT_LOG_CAPACITY: only the rows on screen exist, and each entry is
+ * formatted from the EventLog when its row is bound.
+ *
+ * The screen is one of ScreenManager's: build() and released() are its
+ * hooks, and back returns to the previous screen.
+ */
+class EventScreen
+{
+public:
+  explicit EventScreen(ScreenManager &screens) : screens(screens) {}
+
+  // ScreenManager hooks
+  lv_obj_t *build();
+  void released();
+  // Call after each ScreenManager::show()
+  void show(EventLog &log);
+  // Pick up events raised since the last call; cheap when there are none
+  void update();
+
+  VirtualList &list() { return rows; }
+
+private:
+  void updateTitle();
+  static void fetch(uint32_t index, char *text, size_t size, void *context);
+  static void onBack(lv_event_t *e);
+
+  ScreenManager &screens;
+  EventLog *log = nullptr;
+  lv_obj_t *screen = nullptr;
+  lv_obj_t *title = nullptr;
+  VirtualList rows;
+  uint32_t shown = 0; // EventLog::raised() when the list was last updated
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Destination for HistoryExporter output.
+ *
+ * write() may accept fewer bytes than offered (or none) when the destination
+ * is busy; the exporter keeps the remainder and retries on the next pump().
+ * That is the backpressure path for slow serial links and sockets.
+ */
+class ExportSink
+{
+public:
+  virtual ~ExportSink() = default;
+  virtual size_t write(const uint8_t *data, size_t len) = 0;
+};
+
+#if defined(ARDUINO)
+#include <Print.h>
+#include "FileHandle.h"
+
+// Serial port or network client. With flowControl, only as many bytes as the
+// TX buffer can take are offered so pump() never blocks on a full UART.
+class PrintSink : public ExportSink
+{
+public:
+  explicit PrintSink(Print &target, bool flowControl = true) : out(target), useAvailable(flowControl) {}
+
+  size_t write(const uint8_t *data, size_t len) override
+  {
+    if (useAvailable)
+    {
+      int room = out.availableForWrite();
+      if (room <= 0)
+        return 0;
+      if ((size_t)room < len)
+        len = (size_t)room;
+    }
+    return out.write(data, len);
+  }
+
+private:
+  Print &out;
+  bool useAvailable;
+};
+
+// File on the SD card, through FileManager's buffered handles
+class FileSink : public ExportSink
+{
+public:
+  explicit FileSink(FileHandle &target) : file(target) {}
+
+  size_t write(const uint8_t *data, size_t len) override
+  {
+    return file.write(data, len);
+  }
+
+private:
+  FileHandle &file;
+};
+#endif // ARDUINO
@@ -0,0 +1,152 @@
+#include "FileHandle.h"
+
+bool FileHandle::open(fs::FS &fs, const char *path, FileMode m)
+{
+  const char *modeStr = FILE_READ;
+  if (m == FileMode::Write)
+    modeStr = FILE_WRITE;
+  else if (m == FileMode::Append)
+    modeStr = FILE_APPEND;
+
+  file = fs.open(path, modeStr);
+  if (!file)
+    return false;
+  fileMode = m;
+  inUse = true;
+  bufPos = 0;
+  bufLen = 0;
+  pos = (m == FileMode::Append) ? file.size() : 0;
+  return true;
+}
+
+void FileHandle::close()
+{
+  if (!inUse)
+    return;
+  flush();
+  file.close();
+  inUse = false;
+}
+
+size_t FileHandle::read(void *dst, size_t len)
+{
+  if (!inUse || fileMode != FileMode::Read)
+    return 0;
+
+  uint8_t *out = (uint8_t *)dst;
+  size_t done = 0;
+  while (done < len)
+  {
+    if (bufPos == bufLen)
+    {
+      // Large reads go straight to the card instead of through the buffer
+      if (len - done >= BUFFER_SIZE)
+      {
+        // The buffer no longer describes the bytes around pos; drop it so
+        // seek() cannot mistake it for a window at the new position
+        bufPos = bufLen = 0;
+        size_t n = file.read(out + done, len - done);
+        done += n;
+        pos += n;
+        break;
+      }
+      bufLen = file.read(buf, BUFFER_SIZE);
+      bufPos = 0;
+      if (bufLen == 0)
+        break;
+    }
+    size_t n = bufLen - bufPos;
+    if (n > len - done)
+      n = len - done;
+    memcpy(out + done, buf + bufPos, n);
+    bufPos += n;
+    done += n;
+    pos += n;
+  }
+  return done;
+}
+
+size_t FileHandle::write(const void *src, size_t len)
+{
+  if (!inUse || fileMode == FileMode::Read)
+    return 0;
+
+  const uint8_t *in = (const uint8_t *)src;
+  size_t done = 0;
+  while (done < len)
+  {
+    if (bufLen == 0 && len - done >= BUFFER_SIZE)
+    {
+      size_t n = file.write(in + done, len - done);
+      done += n;
+      pos += n;
+      break;
+    }
+    size_t n = BUFFER_SIZE - bufLen;
+    if (n > len - done)
+      n = len - done;
+    memcpy(buf + bufLen, in + done, n);
+    bufLen += n;
+    done += n;
+    pos += n;
+    if (bufLen == BUFFER_SIZE)
+    {
+      // On failure the data stays buffered and the next flush() reports it
+      if (file.write(buf, bufLen) != bufLen)
+        return done;
+      bufLen = 0;
+    }
+  }
+  return done;
+}
+
+bool FileHandle::flush()
+{
+  if (!inUse)
+    return false;
+  if (fileMode == FileMode::Read)
+    return true;
+  if (bufLen > 0)
+  {
+    if (file.write(buf, bufLen) != bufLen)
+      return false;
+    bufLen = 0;
+  }
+  file.flush();
+  return true;
+}
+
+bool FileHandle::seek(uint32_t target)
+{
+  if (!inUse)
+    return false;
+
+  if (fileMode == FileMode::Read)
+  {
+    // Stay inside the read-ahead buffer when possible
+    uint32_t bufStart = pos - bufPos;
+    if (target >= bufStart && target <= bufStart + bufLen)
+    {
+      bufPos = target - bufStart;
+      pos = target;
+      return true;
+    }
+    bufPos = bufLen = 0;
+  }
+  else if (!flush())
+  {
+    return false;
+  }
+
+  if (!file.seek(target))
+    return false;
+  pos = target;
+  return true;
+}
+
+uint32_t FileHandle::size()
+{
+  if (!inUse)
+    return 0;
+  return file.size() + (uint32_t)pending();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+enum class FileMode : uint8_t
+{
+  Read,
+  Write, // Create or truncate
+  Append
+};
+
+/**
+ * Buffered stream over an SD file, handed out by FileManager from a fixed pool.
+ *
+ * SD over SPI is very slow for record-sized transfers, so each handle owns
+ * one sector-sized buffer used as read-ahead in Read mode and write-behind
+ * in Write/Append mode. Transfers at least as large as the buffer bypass it.
+ *
+ * Buffered writes only reach the card on flush() or close(); flush() also
+ * syncs the file so the data survives a power cut.
+ */
+class FileHandle
+{
+public:
+  static const size_t BUFFER_SIZE = 512; // One SD sector
+
+  size_t read(void *dst, size_t len);
+  size_t write(const void *src, size_t len);
+  bool flush();
+  bool seek(uint32_t pos);
+
+  uint32_t position() const { return pos; }
+  uint32_t size();
+  FileMode mode() const { return fileMode; }
+  // Bytes accepted by write() that have not reached the card yet
+  size_t pending() const { return fileMode == FileMode::Read ? 0 : bufLen; }
+
+private:
+  friend class FileManager;
+
+  bool open(fs::FS &fs, const char *path, FileMode m);
+  void close();
+
+  File file;
+  FileMode fileMode = FileMode::Read;
+  bool inUse = false;
+  uint32_t pos = 0;   // Logical stream position
+  size_t bufPos = 0;  // Read cursor inside buf (Read mode)
+  size_t bufLen = 0;  // Valid bytes in buf
+  uint8_t buf[BUFFER_SIZE];
+};
@@ -0,0 +1,158 @@
+#include "FileManager.h"
+#include "SpiBus.h"
+
+bool FileManager::begin()
+{
+  {
+    // The card shares VSPI with the panel
+    SpiBus::Guard bus;
+    sdReady = SD.begin(SD_CS_PIN);
+  }
+  if (sdReady)
+  {
+    logHandle = openFile(LOG_PATH, FileMode::Append);
+    if (!logHandle)
+      Serial.println("FileManager: could not open SD history log");
+    return logHandle != nullptr;
+  }
+
+  // No card inserted: fall back to the ring log in internal flash
+  if (!flash.partition())
+  {
+    Serial.println("FileManager: no SD card and no spiffs partition for the flash log");
+    return false;
+  }
+  if (!flashLog.begin())
+  {
+    Serial.println("FileManager: flash log mount failed");
+    return false;
+  }
+  Serial.printf("FileManager: no SD card, using flash log (%u records, wear %u..%u)\n",
+                (unsigned)flashLog.count(), (unsigned)flashLog.minEraseCount(), (unsigned)flashLog.maxEraseCount());
+  return true;
+}
+
+FileHandle *FileManager::openFile(const char *filename, FileMode mode)
+{
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  SpiBus::Guard bus(sdReady);
+  if (!sdReady)
+    return nullptr;
+  for (FileHandle &h : handles)
+  {
+    if (h.inUse)
+      continue;
+    return h.open(SD, filename, mode) ? &h : nullptr;
+  }
+  return nullptr; // Pool exhausted
+}
+
+void FileManager::closeFile(FileHandle *handle)
+{
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  SpiBus::Guard bus(sdReady);
+  if (handle && handle != logHandle && handle != readHandle)
+    handle->close();
+}
+
+uint8_t FileManager::openFileCount() const
+{
+  uint8_t n = 0;
+  for (const FileHandle &h : handles)
+    if (h.inUse)
+      n++;
+  return n;
+}
+
+bool FileManager::appendRecord(const LogRecord &rec, bool highPriority)
+{
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  SpiBus::Guard bus(sdReady);
+  bool ok;
+  if (!sdReady)
+    ok = flashLog.append(rec);
+  else
+    ok = logHandle && logHandle->write(&rec, sizeof(rec)) == sizeof(rec);
+  if (!ok)
+    return false;
+
+  if (policy.onWrite(sizeof(rec), millis(), highPriority))
+    return commit(policy.reason());
+  return true;
+}
+
+size_t FileManager::readRecords(uint32_t index, LogRecord *out, size_t max)
+{
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  SpiBus::Guard bus(sdReady);
+  if (!sdReady)
+    return flashLog.read(index, out, max);
+
+  // Make buffered appends visible to the reader; a no-op for most reads
+  if (!logHandle || (policy.pendingBytes() && !commit(CommitPolicy::Reason::Read)))
+    return 0;
+  if (!readHandle)
+    readHandle = openFile(LOG_PATH, FileMode::Read);
+  if (!readHandle)
+    return 0;
+  // Seeking within the read-ahead buffer costs no I/O, so consecutive calls
+  // read the card once per FileHandle::BUFFER_SIZE
+  if (!readHandle->seek((uint32_t)index * sizeof(LogRecord)))
+    return 0;
+  return readHandle->read(out, max * sizeof(LogRecord)) / sizeof(LogRecord);
+}
+
+uint32_t FileManager::recordCount()
+{
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  SpiBus::Guard bus(sdReady);
+  if (!sdReady)
+    return flashLog.count();
+  return logHandle ? logHandle->size() / sizeof(LogRecord) : 0;
+}
+
+bool FileManager::flush()
+{
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  SpiBus::Guard bus(sdReady);
+  return commit(CommitPolicy::Reason::Explicit);
+}
+
+void FileManager::update()
+{
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  if (!policy.due(millis()))
+    return;
+  // Only a due commit touches the card
+  SpiBus::Guard bus(sdReady);
+  commit(CommitPolicy::Reason::Time);
+}
+
+bool FileManager::commit(CommitPolicy::Reason why)
+{
+  uint32_t start = micros();
+  bool appended = policy.pendingBytes() > 0;
+  bool ok;
+  if (!sdReady)
+    ok = flashLog.flush();
+  else
+    ok = logHandle && logHandle->flush();
+  if (ok)
+    policy.committed(micros() - start, why);
+  // The read handle may have buffered, or hit end of file before, the
+  // records just written; reopen it on the next read
+  if (appended && readHandle)
+  {
+    readHandle->close();
+    readHandle = nullptr;
+  }
+  return ok;
+}
+
+bool FileManager::openHistory(HistoryReader &reader)
+{
+  std::lock_guard<std::recursive_mutex> guard(lock);
+  if (!usingFlash() || (policy.pendingBytes() && !commit(CommitPolicy::Reason::Read)))
+    return false;
+  return reader.isOpen() ? reader.refresh() : reader.open(flash.partition());
+}
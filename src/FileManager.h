@@ -4,21 +4,89 @@
 
 #include <Arduino.h>
 #include <SD.h>
+#include <mutex>
+#include "LogRecord.h"
+#include "FileHandle.h"
+#include "CommitPolicy.h"
+#include "FlashRingLog.h"
+#include "PartitionFlash.h"
+#include "HistoryReader.h"
+#include "SpiBus.h"
 
+/**
+ * Storage front end for sensor history.
+ *
+ * Uses the SD card when one is inserted. Many units ship without a card, so
+ * begin() falls back to a FlashRingLog in the spiffs partition from
+ * min_spiffs.csv. Callers use the same append/read API either way.
+ *
+ * SD files are accessed through buffered FileHandles from a fixed pool of
+ * MAX_OPEN_FILES; openFile() returns nullptr when the pool is exhausted.
+ * The history log holds two of them: the append handle, and a read handle
+ * that readRecords() keeps open so sequential reads stay within its
+ * read-ahead buffer instead of reopening the file on every call.
+ *
+ * History appends are group-committed according to a CommitPolicy (size, count,
+ * age or high-priority triggers); call update() periodically so the age
+ * threshold fires even when no new records arrive.
+ *
+ * The record and file methods take an internal lock, so a background task
+ * (HistoryLoader) can read history while the main loop keeps logging. SD
+ * access also holds the SpiBus lock, since the card shares VSPI with the
+ * panel's DMA flush; code using a handle from openFile() directly must do
+ * the same.
+ */
 class FileManager
 {
 private:
   static const uint8_t SD_CS_PIN = 5;
+  static const uint8_t MAX_OPEN_FILES = 4;
+  static constexpr const char *LOG_PATH = "/readings.bin";
+
+  bool sdReady = false;
+  PartitionFlash flash{PartitionFlash::findLogPartition()};
+  FlashRingLog flashLog{flash};
+
+  // Handle pool; the SD history log keeps one append handle open permanently
+  FileHandle handles[MAX_OPEN_FILES];
+  FileHandle *logHandle = nullptr;
+  // Opened on the first readRecords(), closed when a commit appends to the log
+  FileHandle *readHandle = nullptr;
+  CommitPolicy policy;
+  // Recursive: readRecords() commits and opens files under the same lock
+  std::recursive_mutex lock;
+
+  bool commit(CommitPolicy::Reason why);
 
 public:
-  bool begin()
-  {
-    return SD.begin(SD_CS_PIN);
-  }
+  // Returns true if either the SD card or the internal flash log is usable
+  bool begin();
+  bool usingFlash() const { return !sdReady && flashLog.isMounted(); }
 
-  bool openFile(const char *filename)
+  bool exists(const char *filename)
   {
+    SpiBus::Guard bus;
     return SD.exists(filename);
   }
+
+  // Buffered file access on the SD card
+  FileHandle *openFile(const char *filename, FileMode mode = FileMode::Read);
+  void closeFile(FileHandle *handle);
+  uint8_t openFileCount() const;
+
+  // Sensor history log. highPriority (e.g. alerts) commits immediately.
+  // Reads commit only when records are still buffered (Reason::Read).
+  bool appendRecord(const LogRecord &rec, bool highPriority = false);
+  size_t readRecords(uint32_t index, LogRecord *out, size_t max);
+  uint32_t recordCount();
+  // Explicit commit of everything buffered
+  bool flush();
+  // Commits the current batch once it exceeds the policy's age limit
+  void update();
+
+  CommitPolicy &commitPolicy() { return policy; }
+
+  // Zero-copy view of the flash log for chart/export code (flushes pending records first)
+  bool openHistory(HistoryReader &reader);
 };
 #endif
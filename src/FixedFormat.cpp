@@ -0,0 +1,105 @@
+#include "FixedFormat.h"
+#include <math.h>
+#include <string.h>
+
+namespace
+{
+  const uint32_t POW10[] = {1, 10, 100, 1000, 10000, 100000, 1000000,
+                            10000000, 100000000, 1000000000};
+  const uint8_t MAX_FLOAT_DECIMALS = 6;
+}
+
+char *writeUint(char *p, uint32_t v)
+{
+  char tmp[10];
+  int n = 0;
+  do
+  {
+    tmp[n++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v);
+  while (n)
+    *p++ = tmp[--n];
+  return p;
+}
+
+char *writeInt(char *p, int32_t v)
+{
+  if (v < 0)
+  {
+    *p++ = '-';
+    return writeUint(p, (uint32_t)(-(int64_t)v));
+  }
+  return writeUint(p, (uint32_t)v);
+}
+
+char *writeFixed(char *p, int32_t scaled, uint8_t decimals)
+{
+  if (decimals > 9)
+    decimals = 9;
+  uint32_t mag = (uint32_t)scaled;
+  if (scaled < 0)
+  {
+    *p++ = '-';
+    mag = (uint32_t)(-(int64_t)scaled);
+  }
+  p = writeUint(p, mag / POW10[decimals]);
+  if (decimals)
+  {
+    *p++ = '.';
+    // Fraction digits, zero-padded from the right end
+    uint32_t frac = mag % POW10[decimals];
+    for (int i = decimals - 1; i >= 0; i--)
+    {
+      p[i] = (char)('0' + frac % 10);
+      frac /= 10;
+    }
+    p += decimals;
+  }
+  return p;
+}
+
+size_t formatFixed(char *buf, size_t size, float value, uint8_t decimals,
+                   const char *unit, uint8_t width, char pad)
+{
+  if (size == 0)
+    return 0;
+  if (decimals > MAX_FLOAT_DECIMALS)
+    decimals = MAX_FLOAT_DECIMALS;
+
+  // A float has 24 significant bits and 10^6 needs 20, so the product is
+  // exact in a double and rint() (round half to even) rounds like printf
+  char num[FIXED_MAX_LEN];
+  char *end = num;
+  double scaled = (double)value * POW10[decimals];
+  if (fabs(scaled) < 2147483647.0)
+  {
+    end = writeFixed(num, (int32_t)rint(scaled), decimals);
+  }
+  else
+  {
+    *end++ = '-';
+    *end++ = '-';
+    if (decimals)
+    {
+      *end++ = '.';
+      for (uint8_t i = 0; i < decimals; i++)
+        *end++ = '-';
+    }
+  }
+
+  size_t numLen = end - num;
+  size_t unitLen = unit ? strlen(unit) : 0;
+  size_t padLen = width > numLen + unitLen ? width - numLen - unitLen : 0;
+
+  size_t n = 0;
+  size_t limit = size - 1;
+  for (; n < padLen && n < limit; n++)
+    buf[n] = pad;
+  for (size_t i = 0; i < numLen && n < limit; i++)
+    buf[n++] = num[i];
+  for (size_t i = 0; i < unitLen && n < limit; i++)
+    buf[n++] = unit[i];
+  buf[n] = '\0';
+  return n;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Allocation-free number formatting without the printf float machinery.
+ *
+ * The write* functions append to a caller-sized buffer, return the new end
+ * and do not NUL-terminate, so records can be assembled piecewise (see
+ * HistoryExporter). formatFixed() is the NUL-terminated convenience form
+ * used by the UI.
+ *
+ * Rounding matches printf("%.Nf") (round half to even on the exact binary
+ * value), except that values rounding to zero print without a minus sign.
+ */
+
+// Longest output of writeFixed(): sign, 10 digits, point
+static const size_t FIXED_MAX_LEN = 12;
+
+char *writeUint(char *p, uint32_t v);
+char *writeInt(char *p, int32_t v);
+// Fixed-point value scaled by 10^decimals (decimals 0..9): (-123, 1) -> "-12.3"
+char *writeFixed(char *p, int32_t scaled, uint8_t decimals);
+
+/**
+ * Format value with the given decimals (0..6), then unit, right-aligned
+ * in width characters using pad. NaN, infinity and values out of int32
+ * range after scaling are shown as dashes in the same shape ("--.-").
+ *
+ * Returns the length written, excluding the terminator. Output that does
+ * not fit in size is truncated and still terminated.
+ */
+size_t formatFixed(char *buf, size_t size, float value, uint8_t decimals,
+                   const char *unit = "", uint8_t width = 0, char pad = ' ');
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Minimal NOR flash abstraction used by FlashRingLog.
+ *
+ * Semantics follow raw NOR flash: erase works on whole sectors and sets every
+ * byte to 0xFF, program can only clear bits (1 -> 0). Offsets are relative to
+ * the start of the region (partition or image), not absolute flash addresses.
+ *
+ * Backends:
+ * - PartitionFlash: an ESP32 data partition (device builds)
+ * - SimulatedFlash: an in-memory/file image for host builds
+ */
+class FlashDevice
+{
+public:
+  virtual ~FlashDevice() = default;
+
+  virtual size_t size() const = 0;
+  virtual size_t sectorSize() const = 0;
+  virtual size_t pageSize() const = 0;
+
+  virtual bool read(size_t offset, void *dst, size_t len) = 0;
+  // Program must not cross a page boundary; callers batch whole pages.
+  virtual bool program(size_t offset, const void *src, size_t len) = 0;
+  virtual bool eraseSector(size_t sector) = 0;
+
+  size_t sectorCount() const { return size() / sectorSize(); }
+};
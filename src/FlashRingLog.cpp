@@ -0,0 +1,270 @@
+#include "FlashRingLog.h"
+#include <string.h>
+
+FlashRingLog::FlashRingLog(FlashDevice &device)
+    : flash(device), mounted(false), sectors(0), rps(0), head(0), tail(0), headSeq(0), headFill(0),
+      pendingOffset(0), pendingLen(0)
+{
+}
+
+bool FlashRingLog::begin()
+{
+  mounted = false;
+  pendingLen = 0;
+  sectors = flash.sectorCount();
+  size_t page = flash.pageSize();
+  if (sectors < 2 || page > MAX_PAGE_SIZE || page % sizeof(LogRecord) != 0)
+    return false;
+  rps = (flash.sectorSize() - HEADER_SIZE) / sizeof(LogRecord);
+
+  // Pass 1: read every header, remember wear and find the newest sector
+  eraseCounts.assign(sectors, 0);
+  std::vector<uint32_t> seqs(sectors, 0);
+  std::vector<bool> valid(sectors, false);
+  bool found = false;
+  for (size_t i = 0; i < sectors; i++)
+  {
+    SectorHeader h;
+    if (!readHeader(i, h))
+      continue;
+    valid[i] = true;
+    seqs[i] = h.sequence;
+    eraseCounts[i] = h.eraseCount;
+    if (!found || (int32_t)(h.sequence - headSeq) > 0)
+    {
+      head = i;
+      headSeq = h.sequence;
+      found = true;
+    }
+  }
+  // A sector whose header was lost (torn write, power cut after its erase)
+  // has no record of its wear; assume it is as worn as the most worn one
+  // rather than new, so it is not picked first and worn further
+  uint32_t worn = 0;
+  for (size_t i = 0; i < sectors; i++)
+    if (valid[i] && eraseCounts[i] > worn)
+      worn = eraseCounts[i];
+  for (size_t i = 0; i < sectors; i++)
+    if (!valid[i])
+      eraseCounts[i] = worn;
+  if (!found)
+    return format();
+
+  // Pass 2: walk backwards from the head while sequence numbers stay contiguous
+  tail = head;
+  for (size_t k = 1; k < sectors; k++)
+  {
+    size_t prev = (head + sectors - k) % sectors;
+    if (!valid[prev] || seqs[prev] != headSeq - k)
+      break;
+    tail = prev;
+  }
+
+  headFill = findFill(head);
+  mounted = true;
+  return true;
+}
+
+bool FlashRingLog::format()
+{
+  mounted = false;
+  pendingLen = 0;
+  if (sectors < 2)
+    return false;
+
+  // Invalidate every sector that could be mistaken for part of the ring
+  size_t start = 0;
+  for (size_t i = 0; i < sectors; i++)
+  {
+    SectorHeader h;
+    if (readHeader(i, h))
+    {
+      if (!flash.eraseSector(i))
+        return false;
+      eraseCounts[i]++;
+    }
+    if (eraseCounts[i] < eraseCounts[start])
+      start = i;
+  }
+
+  if (!openSector(start, 1))
+    return false;
+  head = tail = start;
+  headSeq = 1;
+  headFill = 0;
+  mounted = true;
+  return true;
+}
+
+bool FlashRingLog::append(const LogRecord &rec)
+{
+  if (!mounted)
+    return false;
+  if (headFill == rps)
+  {
+    if (!flush() || !advance())
+      return false;
+  }
+
+  size_t off = slotOffset(head, headFill);
+  if (pendingLen == 0)
+    pendingOffset = off;
+  memcpy(pageBuf + pendingLen, &rec, sizeof(rec));
+  pendingLen += sizeof(rec);
+  headFill++;
+
+  // Program once the page (or the sector) is full
+  if ((off + sizeof(rec)) % flash.pageSize() == 0 || headFill == rps)
+    return flush();
+  return true;
+}
+
+bool FlashRingLog::flush()
+{
+  if (pendingLen == 0)
+    return true;
+  if (!flash.program(pendingOffset, pageBuf, pendingLen))
+    return false;
+  pendingLen = 0;
+  return true;
+}
+
+uint32_t FlashRingLog::count() const
+{
+  if (!mounted)
+    return 0;
+  size_t fullSectors = (head + sectors - tail) % sectors;
+  return (uint32_t)(fullSectors * rps) + headFill;
+}
+
+size_t FlashRingLog::read(uint32_t index, LogRecord *out, size_t max)
+{
+  uint32_t total = count();
+  if (index >= total)
+    return 0;
+  size_t n = total - index;
+  if (n > max)
+    n = max;
+
+  size_t done = 0;
+  while (done < n)
+  {
+    uint32_t idx = index + done;
+    size_t sector = (tail + idx / rps) % sectors;
+    uint32_t slot = idx % rps;
+    size_t run = rps - slot;
+    if (run > n - done)
+      run = n - done;
+    size_t off = slotOffset(sector, slot);
+
+    // Records not yet programmed are served from the page buffer
+    size_t fromFlash = run;
+    if (sector == head && pendingLen > 0 && off + run * sizeof(LogRecord) > pendingOffset)
+      fromFlash = off < pendingOffset ? (pendingOffset - off) / sizeof(LogRecord) : 0;
+
+    if (fromFlash > 0 && !flash.read(off, out + done, fromFlash * sizeof(LogRecord)))
+      return done;
+    if (run > fromFlash)
+    {
+      size_t bufPos = off + fromFlash * sizeof(LogRecord) - pendingOffset;
+      memcpy(out + done + fromFlash, pageBuf + bufPos, (run - fromFlash) * sizeof(LogRecord));
+    }
+    done += run;
+  }
+  return done;
+}
+
+uint32_t FlashRingLog::minEraseCount() const
+{
+  uint32_t m = UINT32_MAX;
+  for (uint32_t e : eraseCounts)
+    if (e < m)
+      m = e;
+  return eraseCounts.empty() ? 0 : m;
+}
+
+uint32_t FlashRingLog::maxEraseCount() const
+{
+  uint32_t m = 0;
+  for (uint32_t e : eraseCounts)
+    if (e > m)
+      m = e;
+  return m;
+}
+
+bool FlashRingLog::readHeader(size_t sector, SectorHeader &h)
+{
+  if (!flash.read(sector * flash.sectorSize(), &h, sizeof(h)))
+    return false;
+  return isValidHeader(h);
+}
+
+bool FlashRingLog::isBlank(size_t sector)
+{
+  uint32_t words[16];
+  for (size_t off = 0; off < flash.sectorSize(); off += sizeof(words))
+  {
+    if (!flash.read(sector * flash.sectorSize() + off, words, sizeof(words)))
+      return false;
+    for (uint32_t w : words)
+      if (w != 0xFFFFFFFFu)
+        return false;
+  }
+  return true;
+}
+
+bool FlashRingLog::openSector(size_t sector, uint32_t sequence)
+{
+  // A sector that is still erased (new flash, or just invalidated by
+  // format()) takes its header without another erase
+  uint32_t erases = eraseCounts[sector];
+  if (!isBlank(sector))
+  {
+    if (!flash.eraseSector(sector))
+      return false;
+    eraseCounts[sector] = ++erases;
+  }
+
+  SectorHeader h;
+  h.magic = MAGIC;
+  h.sequence = sequence;
+  h.eraseCount = erases;
+  h.check = ~(h.magic ^ h.sequence ^ h.eraseCount);
+  return flash.program(sector * flash.sectorSize(), &h, sizeof(h));
+}
+
+bool FlashRingLog::advance()
+{
+  size_t next = (head + 1) % sectors;
+  // Ring full: drop the oldest sector
+  if (next == tail)
+    tail = (tail + 1) % sectors;
+  if (!openSector(next, headSeq + 1))
+    return false;
+  head = next;
+  headSeq++;
+  headFill = 0;
+  return true;
+}
+
+uint32_t FlashRingLog::findFill(size_t sector)
+{
+  // Slots are written in order, so the first empty one can be binary searched
+  uint32_t lo = 0, hi = rps;
+  while (lo < hi)
+  {
+    uint32_t mid = lo + (hi - lo) / 2;
+    uint32_t ts = LOG_TIMESTAMP_EMPTY;
+    flash.read(slotOffset(sector, mid), &ts, sizeof(ts));
+    if (ts == LOG_TIMESTAMP_EMPTY)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+size_t FlashRingLog::slotOffset(size_t sector, uint32_t slot) const
+{
+  return sector * flash.sectorSize() + HEADER_SIZE + (size_t)slot * sizeof(LogRecord);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "FlashDevice.h"
+#include "LogRecord.h"
+
+/**
+ * Append-only ring log of LogRecords in raw NOR flash.
+ *
+ * Used as the storage fallback when no SD card is fitted. Layout per sector:
+ *
+ *   [SectorHeader 16 B][LogRecord 8 B] x recordsPerSector()
+ *
+ * - Sectors are filled strictly in ring order, so every sector takes at most
+ *   one erase per pass over the partition (wear is spread evenly); a sector
+ *   that is still blank is not erased again. Each header carries the
+ *   sector's erase count so wear survives reboots, and a fresh format starts
+ *   from the least-worn sector. A sector whose header is lost counts as the
+ *   most worn.
+ * - Appends are collected in a one-page RAM buffer and programmed a page at a
+ *   time instead of one 8-byte write per sample. Call flush() to force the
+ *   pending partial page out (e.g. before sleep or on an alert).
+ * - When the ring is full the oldest sector is erased and reused.
+ *
+ * Mounting scans only the sector headers plus a binary search inside the
+ * newest sector, so begin() stays cheap on large partitions.
+ */
+class FlashRingLog
+{
+public:
+  static const uint32_t MAGIC = 0x474F4C52; // "RLOG"
+  static const size_t HEADER_SIZE = 16;
+  static const size_t MAX_PAGE_SIZE = 256;
+
+  explicit FlashRingLog(FlashDevice &device);
+
+  // Mount an existing log or format a blank/foreign region
+  bool begin();
+  // Discard all records and restart at the least-worn sector
+  bool format();
+  bool isMounted() const { return mounted; }
+
+  bool append(const LogRecord &rec);
+  bool flush();
+
+  // Number of records stored, including ones still waiting in the page buffer
+  uint32_t count() const;
+  // Copy records starting at index (0 = oldest); returns how many were read
+  size_t read(uint32_t index, LogRecord *out, size_t max);
+
+  uint32_t recordsPerSector() const { return rps; }
+  uint32_t minEraseCount() const;
+  uint32_t maxEraseCount() const;
+
+  // On-flash sector header, public so read-only views (HistoryReader) can parse the layout
+  struct SectorHeader
+  {
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t eraseCount;
+    uint32_t check; // ~(magic ^ sequence ^ eraseCount), catches torn header writes
+  };
+  static_assert(sizeof(SectorHeader) == HEADER_SIZE, "SectorHeader size mismatch");
+
+  static bool isValidHeader(const SectorHeader &h)
+  {
+    return h.magic == MAGIC && h.check == ~(h.magic ^ h.sequence ^ h.eraseCount);
+  }
+
+private:
+  bool readHeader(size_t sector, SectorHeader &h);
+  bool isBlank(size_t sector);
+  bool openSector(size_t sector, uint32_t sequence);
+  bool advance();
+  uint32_t findFill(size_t sector);
+  size_t slotOffset(size_t sector, uint32_t slot) const;
+
+  FlashDevice &flash;
+  bool mounted;
+  size_t sectors;
+  uint32_t rps;
+
+  size_t head; // Sector currently being filled
+  size_t tail; // Oldest sector still holding records
+  uint32_t headSeq;
+  uint32_t headFill; // Records in the head sector, pending ones included
+  std::vector<uint32_t> eraseCounts;
+
+  // Page batch buffer: pendingLen bytes destined for flash at pendingOffset
+  uint8_t pageBuf[MAX_PAGE_SIZE];
+  size_t pendingOffset;
+  size_t pendingLen;
+};
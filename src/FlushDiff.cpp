@@ -0,0 +1,105 @@
+#include "FlushDiff.h"
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+  // 0 is reserved for "unknown", so a fresh or reset table never matches
+  uint32_t hashTile(const uint16_t *px, uint16_t count)
+  {
+    uint32_t h = 0x811C9DC5;
+    const uint32_t *words = (const uint32_t *)px;
+    for (uint16_t i = 0; i < count / 2; i++)
+      h = (h ^ words[i]) * 0x01000193;
+    h ^= h >> 15;
+    return h ? h : 1;
+  }
+}
+
+FlushDiff::~FlushDiff()
+{
+  free(hashes);
+}
+
+bool FlushDiff::begin(uint16_t w, uint16_t h, uint16_t tileWidth)
+{
+  free(hashes);
+  hashes = nullptr;
+  if (tileWidth < 2 || (tileWidth & (tileWidth - 1)) || w % tileWidth)
+    return false;
+  width = w;
+  height = h;
+  tile = tileWidth;
+  tilesPerRow = w / tileWidth;
+  hashes = (uint32_t *)calloc((size_t)tilesPerRow * height, sizeof(uint32_t));
+  return hashes != nullptr;
+}
+
+void FlushDiff::reset()
+{
+  if (hashes)
+    memset(hashes, 0, (size_t)tilesPerRow * height * sizeof(uint32_t));
+}
+
+uint32_t FlushDiff::push(DisplayHAL &panel, int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *pixels)
+{
+  if (!hashes || x < 0 || y < 0 || x + w > width || y + h > height || x % tile || w % tile)
+  {
+    panel.pushPixels(x, y, w, h, pixels);
+    return (uint32_t)(w * h);
+  }
+
+  // Packed output always trails the rows still to be read, so compaction is
+  // safe in place, and a run already handed to the panel is never overwritten
+  uint16_t *packed = pixels;
+  uint16_t *runStart = nullptr;
+  int32_t runY = 0, runRows = 0, runFirst = 0, runLast = 0;
+  uint32_t sent = 0;
+  int32_t tiles = w / tile;
+
+  auto flushRun = [&]()
+  {
+    if (!runRows)
+      return;
+    int32_t runW = (runLast - runFirst + 1) * tile;
+    panel.pushPixels(x + runFirst * tile, y + runY, runW, runRows, runStart);
+    sent += (uint32_t)(runW * runRows);
+    runRows = 0;
+  };
+
+  for (int32_t row = 0; row < h; row++)
+  {
+    const uint16_t *src = pixels + (size_t)row * w;
+    uint32_t *known = hashes + (size_t)(y + row) * tilesPerRow + x / tile;
+    int32_t first = -1, last = -1;
+    for (int32_t t = 0; t < tiles; t++)
+    {
+      uint32_t hv = hashTile(src + t * tile, tile);
+      if (known[t] != hv)
+      {
+        known[t] = hv;
+        if (first < 0)
+          first = t;
+        last = t;
+      }
+    }
+
+    if (first < 0 || !(runRows && first == runFirst && last == runLast && runY + runRows == row))
+      flushRun();
+    if (first < 0)
+      continue;
+    if (!runRows)
+    {
+      runStart = packed;
+      runY = row;
+      runFirst = first;
+      runLast = last;
+    }
+    size_t count = (size_t)(last - first + 1) * tile;
+    memmove(packed, src + first * tile, count * sizeof(uint16_t));
+    packed += count;
+    runRows++;
+  }
+  flushRun();
+  return sent;
+}
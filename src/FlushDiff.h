@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "DisplayHAL.h"
+
+/**
+ * Skips flushing pixels the panel already shows.
+ *
+ * Keeps a 32-bit hash for every tile of TILE pixels along each row of the
+ * screen (20 x 240 hashes, about 19 KB, for a 320x240 panel; a shadow
+ * framebuffer would need 150 KB). For each flushed block, rows whose tiles
+ * all match are dropped. The changed span of each remaining row is packed
+ * in place in the draw buffer, and consecutive rows with the same span go
+ * out as one address window.
+ *
+ * Blocks must start and end on tile boundaries horizontally (TemplateCode
+ * sets an LVGL rounder_cb for this); anything else is pushed unchanged.
+ * A hash collision would leave a stale tile on screen; with 32-bit hashes
+ * that is a ~2^-32 chance per changed tile.
+ */
+class FlushDiff
+{
+public:
+  ~FlushDiff();
+
+  // Allocate hashes for a width x height screen; tile must be a power of two dividing width
+  bool begin(uint16_t width, uint16_t height, uint16_t tile);
+  // Forget what the panel shows (after rotation, or anything drawing behind our back)
+  void reset();
+  bool active() const { return hashes != nullptr; }
+  uint16_t tileSize() const { return tile; }
+
+  // Push the changed parts of a w x h block at (x, y). Modifies pixels (in
+  // place compaction); returns the number of pixels actually sent.
+  uint32_t push(DisplayHAL &panel, int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *pixels);
+
+private:
+  uint32_t *hashes = nullptr;
+  uint16_t width = 0;
+  uint16_t height = 0;
+  uint16_t tile = 16;
+  uint16_t tilesPerRow = 0;
+};
@@ -0,0 +1,143 @@
+#include "HistoryExporter.h"
+#include <string.h>
+#include "FixedFormat.h"
+
+namespace
+{
+  // Longest formatted record: JSON with 10-digit timestamp and both values
+  const size_t MAX_RECORD_LEN = 80;
+
+  const char CSV_HEADER[] = "timestamp,temperature_c,humidity_pct\n";
+  const char JSON_HEADER[] = "[\n";
+  const char JSON_FOOTER[] = "\n]\n";
+
+  char *writeText(char *p, const char *s, size_t len)
+  {
+    memcpy(p, s, len);
+    return p + len;
+  }
+}
+
+HistoryExporter::HistoryExporter(ExportSink &target, Format fmt)
+    : sink(target), format(fmt)
+{
+}
+
+void HistoryExporter::begin(BlockFetch fetchFn, uint32_t first, uint32_t count)
+{
+  fetch = fetchFn;
+  next = first;
+  end = (count > UINT32_MAX - first) ? UINT32_MAX : first + count;
+  records = 0;
+  bytes = 0;
+  span = RecordSpan{nullptr, 0};
+  spanPos = 0;
+  outLen = outPos = 0;
+  state = State::Header;
+}
+
+void HistoryExporter::begin(const HistoryReader &reader, uint32_t first, uint32_t count)
+{
+  // Spans point straight into the mapped partition; scratch is never touched
+  begin([&reader](uint32_t index, LogRecord *, size_t max)
+        { return reader.spanAt(index, max); },
+        first, count);
+}
+
+bool HistoryExporter::pump(size_t budget)
+{
+  size_t sent = 0;
+  while (running() || outPos < outLen)
+  {
+    if (outPos == outLen)
+    {
+      outPos = outLen = 0;
+      fill();
+      if (outLen == 0)
+        break;
+    }
+
+    size_t n = sink.write((const uint8_t *)out + outPos, outLen - outPos);
+    outPos += n;
+    bytes += n;
+    sent += n;
+    // Sink is full: yield and retry the remainder next time
+    if (n == 0 || sent >= budget)
+      return true;
+  }
+  return running() || outPos < outLen;
+}
+
+void HistoryExporter::fill()
+{
+  char *p = out;
+  char *limit = out + OUT_BUFFER_SIZE;
+
+  if (state == State::Header)
+  {
+    if (format == Format::Csv)
+      p = writeText(p, CSV_HEADER, sizeof(CSV_HEADER) - 1);
+    else
+      p = writeText(p, JSON_HEADER, sizeof(JSON_HEADER) - 1);
+    state = State::Records;
+  }
+
+  while (state == State::Records && p + MAX_RECORD_LEN <= limit)
+  {
+    if (spanPos == span.size)
+    {
+      size_t want = end - next;
+      if (want > BLOCK_RECORDS)
+        want = BLOCK_RECORDS;
+      span = (want > 0 && fetch) ? fetch(next, scratch, want) : RecordSpan{nullptr, 0};
+      spanPos = 0;
+      if (span.empty())
+      {
+        state = State::Footer;
+        break;
+      }
+    }
+    p += formatRecord(span.data[spanPos++], p);
+    next++;
+    records++;
+  }
+
+  if (state == State::Footer && p + sizeof(JSON_FOOTER) <= limit)
+  {
+    if (format == Format::Json)
+      p = writeText(p, JSON_FOOTER, sizeof(JSON_FOOTER) - 1);
+    state = State::Done;
+  }
+
+  outLen = p - out;
+}
+
+size_t HistoryExporter::formatRecord(const LogRecord &rec, char *dst)
+{
+  char *p = dst;
+  if (format == Format::Csv)
+  {
+    // Invalid readings are left as empty fields
+    p = writeUint(p, rec.timestamp);
+    *p++ = ',';
+    if (rec.temperature != LOG_TEMP_INVALID)
+      p = writeFixed(p, rec.temperature, 1);
+    *p++ = ',';
+    if (rec.humidity != LOG_HUMIDITY_INVALID)
+      p = writeFixed(p, rec.humidity, 1);
+    *p++ = '\n';
+  }
+  else
+  {
+    if (records > 0)
+      p = writeText(p, ",\n", 2);
+    p = writeText(p, "{\"timestamp\":", 13);
+    p = writeUint(p, rec.timestamp);
+    p = writeText(p, ",\"temperature\":", 15);
+    p = rec.temperature != LOG_TEMP_INVALID ? writeFixed(p, rec.temperature, 1) : writeText(p, "null", 4);
+    p = writeText(p, ",\"humidity\":", 12);
+    p = rec.humidity != LOG_HUMIDITY_INVALID ? writeFixed(p, rec.humidity, 1) : writeText(p, "null", 4);
+    *p++ = '}';
+  }
+  return p - dst;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include "ExportSink.h"
+#include "HistoryReader.h"
+#include "LogRecord.h"
+
+/**
+ * Streams stored history out as CSV or JSON with constant memory use.
+ *
+ * Records are pulled one block at a time (zero-copy spans from a
+ * HistoryReader, or up to BLOCK_RECORDS copied into a scratch block from
+ * FileManager::readRecords), formatted into a small output buffer and
+ * handed to an ExportSink. Nothing proportional to the history size is
+ * ever held in RAM.
+ *
+ * The export is cooperative: call pump() from loop() or a scheduler task
+ * until it returns false. When the sink stops accepting bytes pump() returns
+ * early and resumes from the same byte next time.
+ *
+ * Numbers are written with integer arithmetic from the fixed-point record
+ * fields, never through printf's float path.
+ */
+class HistoryExporter
+{
+public:
+  enum class Format : uint8_t
+  {
+    Csv,
+    Json
+  };
+
+  static const size_t BLOCK_RECORDS = 64;
+  static const size_t OUT_BUFFER_SIZE = 512;
+
+  // Return the records starting at index: either a span into mapped memory or
+  // a span over scratch after filling it. An empty span ends the export.
+  using BlockFetch = std::function<RecordSpan(uint32_t index, LogRecord *scratch, size_t max)>;
+
+  explicit HistoryExporter(ExportSink &sink, Format format = Format::Csv);
+
+  void begin(BlockFetch fetch, uint32_t first = 0, uint32_t count = UINT32_MAX);
+  void begin(const HistoryReader &reader, uint32_t first = 0, uint32_t count = UINT32_MAX);
+
+  // Write up to roughly budget bytes; returns true while the export is still running
+  bool pump(size_t budget = 4096);
+  bool running() const { return state != State::Idle && state != State::Done; }
+
+  uint32_t recordsExported() const { return records; }
+  uint32_t bytesWritten() const { return bytes; }
+
+private:
+  enum class State : uint8_t
+  {
+    Idle,
+    Header,
+    Records,
+    Footer,
+    Done
+  };
+
+  void fill();
+  size_t formatRecord(const LogRecord &rec, char *dst);
+
+  ExportSink &sink;
+  Format format;
+  State state = State::Idle;
+  BlockFetch fetch;
+
+  uint32_t next = 0; // Next record index to fetch
+  uint32_t end = 0;  // One past the last index to export
+  uint32_t records = 0;
+  uint32_t bytes = 0;
+
+  RecordSpan span{nullptr, 0};
+  size_t spanPos = 0;
+  LogRecord scratch[BLOCK_RECORDS];
+
+  char out[OUT_BUFFER_SIZE];
+  size_t outLen = 0;
+  size_t outPos = 0;
+};
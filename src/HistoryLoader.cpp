@@ -0,0 +1,271 @@
+#include "HistoryLoader.h"
+
+namespace
+{
+  // Rounded to nearest, also for negative temperatures
+  int32_t roundedMean(int32_t sum, uint32_t n)
+  {
+    return sum >= 0 ? (sum + (int32_t)n / 2) / (int32_t)n : (sum - (int32_t)n / 2) / (int32_t)n;
+  }
+}
+
+void HistoryLoader::lock()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  portENTER_CRITICAL(&mux);
+#endif
+}
+
+void HistoryLoader::unlock()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  portEXIT_CRITICAL(&mux);
+#endif
+}
+
+bool HistoryLoader::begin()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  if (task)
+    return true;
+  // Below the Arduino loop's priority, on the other core
+  return xTaskCreatePinnedToCore(taskMain, "history", 4096, this, 1, &task, 0) == pdPASS;
+#else
+  return true;
+#endif
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+void HistoryLoader::taskMain(void *arg)
+{
+  auto *self = (HistoryLoader *)arg;
+  for (;;)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    // Yield a tick between slices so storage and the idle task get a turn
+    while (self->step(256))
+      vTaskDelay(1);
+  }
+}
+#endif
+
+uint32_t HistoryLoader::request(uint32_t records, uint32_t offset, uint16_t points)
+{
+  lock();
+  pending = {records, offset, points};
+  uint32_t gen = ++requested;
+  unlock();
+#if defined(ARDUINO_ARCH_ESP32)
+  if (task)
+    xTaskNotifyGive(task);
+#endif
+  return gen;
+}
+
+bool HistoryLoader::take(HistoryView &out)
+{
+  lock();
+  // Views for superseded requests are dropped; the old one stays on screen meanwhile
+  bool fresh = publishedVersion != takenVersion && publishedGen == requested;
+  if (fresh)
+  {
+    out = published;
+    takenVersion = publishedVersion;
+  }
+  unlock();
+  return fresh;
+}
+
+void HistoryLoader::poll(uint32_t budget)
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  if (task)
+    return;
+#endif
+  step(budget);
+}
+
+void HistoryLoader::start()
+{
+  lock();
+  Request r = pending;
+  working = requested;
+  unlock();
+
+  uint32_t stored = count();
+  totalRecords = stored;
+  end = stored - (r.offset < stored ? r.offset : stored);
+  uint32_t first = end > r.records ? end - r.records : 0;
+  uint32_t n = end - first;
+  uint16_t points = r.points < HistoryView::MAX_POINTS ? r.points : HistoryView::MAX_POINTS;
+  if (points > n)
+    points = (uint16_t)n;
+  uint32_t perPoint = points ? (n + points - 1) / points : 1;
+  if (perPoint >= BUCKET)
+  {
+    // Whole buckets per point, so the summary cache can answer them
+    first -= first % BUCKET;
+    n = end - first;
+    perPoint = ((n + points - 1) / points + BUCKET - 1) / BUCKET * BUCKET;
+  }
+
+  view.generation = working;
+  view.first = first;
+  view.perPoint = perPoint;
+  view.points = points ? (uint16_t)((n + view.perPoint - 1) / view.perPoint) : 0;
+  view.refinedPoints = 0;
+  point = 0;
+  phase = Phase::Coarse;
+  if (!view.points)
+  {
+    // Nothing stored in the window: publish the empty view so the UI can say so
+    publish();
+    phase = Phase::Idle;
+  }
+}
+
+bool HistoryLoader::step(uint32_t budget)
+{
+  lock();
+  bool superseded = requested != working;
+  unlock();
+  if (superseded)
+    start();
+
+  while (budget && phase != Phase::Idle)
+  {
+    if (phase == Phase::Coarse)
+    {
+      // One record from the middle of each point's share of the window
+      uint32_t index = view.first + point * view.perPoint + view.perPoint / 2;
+      if (index >= end)
+        index = end - 1;
+      LogRecord rec;
+      if (fetch(index, &rec, 1) != 1)
+        rec = makeLogRecord(0, NAN, NAN);
+      view.temperature[point] = rec.temperature;
+      view.humidity[point] = rec.humidity;
+      budget--;
+      if (++point < view.points)
+        continue;
+
+      // One record per point is already exact
+      if (view.perPoint == 1)
+        view.refinedPoints = view.points;
+      publish();
+      phase = view.complete() ? Phase::Idle : Phase::Fine;
+      point = 0;
+      pos = view.first;
+      tempSum = tempCount = humSum = humCount = 0;
+      bucketSums.bucket = 0;
+      continue;
+    }
+
+    uint32_t pointEnd = view.first + (point + 1) * view.perPoint;
+    if (pointEnd > end)
+      pointEnd = end;
+    if (pos % BUCKET == 0 && pos < pointEnd)
+    {
+      // Nothing of this bucket is read yet: take it from the cache when the
+      // point covers all of it, else summarise it while reading
+      uint32_t bucket = pos / BUCKET;
+      if (pos + BUCKET <= pointEnd && cache[bucket % HISTORY_CACHE_BUCKETS].bucket == bucket + 1)
+      {
+        budget--;
+        if (addCached(bucket))
+        {
+          pos += BUCKET;
+          if (pos < pointEnd)
+            continue;
+        }
+      }
+      if (pos < pointEnd)
+        bucketSums = {bucket + 1, 0, 0, 0, 0, 0};
+    }
+
+    size_t n = 0;
+    if (pos < pointEnd && budget)
+    {
+      // Chunks stop at bucket boundaries so whole buckets can be cached
+      uint32_t stop = (pos / BUCKET + 1) * BUCKET;
+      if (stop > pointEnd)
+        stop = pointEnd;
+      uint32_t want = stop - pos;
+      if (want > CHUNK)
+        want = CHUNK;
+      if (want > budget)
+        want = budget;
+      n = fetch(pos, chunk, want);
+      if (n && pos % BUCKET == 0)
+        bucketSums.timestamp = chunk[0].timestamp;
+      for (size_t i = 0; i < n; i++)
+      {
+        if (chunk[i].temperature != LOG_TEMP_INVALID)
+        {
+          tempSum += chunk[i].temperature;
+          tempCount++;
+          bucketSums.tempSum += chunk[i].temperature;
+          bucketSums.tempCount++;
+        }
+        if (chunk[i].humidity != LOG_HUMIDITY_INVALID)
+        {
+          humSum += chunk[i].humidity;
+          humCount++;
+          bucketSums.humSum += chunk[i].humidity;
+          bucketSums.humCount++;
+        }
+      }
+      // An unreadable stretch is skipped rather than retried forever, and
+      // the bucket it is in is not cached
+      if (!n)
+        bucketSums.bucket = 0;
+      pos = n ? pos + n : pointEnd;
+      budget -= n ? n : 1;
+      if (bucketSums.bucket && pos == bucketSums.bucket * BUCKET)
+      {
+        cache[(bucketSums.bucket - 1) % HISTORY_CACHE_BUCKETS] = bucketSums;
+        bucketSums.bucket = 0;
+      }
+    }
+    if (pos < pointEnd)
+      continue;
+
+    view.temperature[point] = tempCount ? (int16_t)roundedMean(tempSum, tempCount) : LOG_TEMP_INVALID;
+    view.humidity[point] = humCount ? (uint16_t)roundedMean((int32_t)humSum, humCount) : LOG_HUMIDITY_INVALID;
+    tempSum = tempCount = humSum = humCount = 0;
+    view.refinedPoints = ++point;
+    if (point == view.points)
+    {
+      publish();
+      phase = Phase::Idle;
+    }
+    else if (point % REFINE_BATCH == 0)
+    {
+      publish();
+    }
+  }
+  return phase != Phase::Idle;
+}
+
+bool HistoryLoader::addCached(uint32_t bucket)
+{
+  const BucketSummary &entry = cache[bucket % HISTORY_CACHE_BUCKETS];
+  LogRecord rec;
+  // The store may have dropped old records since: the indexes moved on
+  if (fetch(bucket * BUCKET, &rec, 1) != 1 || rec.timestamp != entry.timestamp)
+    return false;
+  tempSum += entry.tempSum;
+  tempCount += entry.tempCount;
+  humSum += entry.humSum;
+  humCount += entry.humCount;
+  return true;
+}
+
+void HistoryLoader::publish()
+{
+  lock();
+  published = view;
+  publishedGen = view.generation;
+  publishedVersion = ++version;
+  unlock();
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "LogRecord.h"
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+// Summary cache entries (20 bytes each); the default covers a 30 day view
+// at the default bucket size with room to pan
+#ifndef HISTORY_CACHE_BUCKETS
+#define HISTORY_CACHE_BUCKETS 768
+#endif
+
+/**
+ * A window of history reduced to one point per chart column.
+ *
+ * Indexes are logical record indexes (0 = oldest stored record), so the
+ * x axis is one LOG_INTERVAL_MS per record regardless of the timestamps.
+ */
+struct HistoryView
+{
+  static const uint16_t MAX_POINTS = 160;
+
+  uint32_t generation = 0; // request this view answers; 0 = nothing loaded
+  uint32_t first = 0;      // record index of the first point
+  uint32_t perPoint = 1;   // records averaged into each point
+  uint16_t points = 0;
+  uint16_t refinedPoints = 0; // leading points that are exact means, the rest are samples
+  int16_t temperature[MAX_POINTS];
+  uint16_t humidity[MAX_POINTS];
+
+  bool complete() const { return points && refinedPoints == points; }
+};
+
+/**
+ * Loads history views off the UI thread.
+ *
+ * A request names a window (records, ending some records before the newest)
+ * and a point count, normally the chart's width in pixels. Each point
+ * averages its share of the window and only the points are held in RAM.
+ *
+ * Sums of every whole BUCKET of records read are kept in a direct-mapped
+ * summary cache. Points of a bucket or more are widened to whole buckets
+ * (and the window's start moved back to a bucket boundary) so they are
+ * built from the cache: the first 30 day view reads every record, later
+ * views of the same span read one record per bucket, the first one, to
+ * check its timestamp. A store that drops its oldest records shifts the
+ * logical indexes; the check turns the shifted buckets into misses.
+ *
+ * Loading is progressive: a coarse view sampling one record per point is
+ * published first, then points are replaced by their exact means as the
+ * window is read, with a view published every REFINE_BATCH points. A new
+ * request abandons the current one at the next slice.
+ *
+ * On the ESP32 the work runs in a low-priority task on core 0 (the Arduino
+ * loop and LVGL run on core 1). Elsewhere poll() does it in slices on the
+ * caller's thread. fetch/count are called from the loader's thread and
+ * must be thread-safe and, when they touch the SD card, hold the SpiBus
+ * lock so they never run under the panel's DMA flush on core 1
+ * (FileManager's readRecords()/recordCount() do both).
+ */
+class HistoryLoader
+{
+public:
+  // Read up to max records from a logical index; returns how many were read
+  using Fetch = size_t (*)(uint32_t index, LogRecord *out, size_t max);
+  // Number of stored records
+  using Count = uint32_t (*)();
+
+  // Records summarised by one cache entry, an hour at the default interval
+  static const uint16_t BUCKET = 60;
+  static_assert(BUCKET <= 255, "bucket counts are kept in 8 bits");
+
+  HistoryLoader(Fetch fetch, Count count) : fetch(fetch), count(count) {}
+  HistoryLoader(const HistoryLoader &) = delete;
+  HistoryLoader &operator=(const HistoryLoader &) = delete;
+
+  // Start the background task (ESP32 only; elsewhere a no-op)
+  bool begin();
+
+  // Ask for `records` records ending `offset` records before the newest, at
+  // up to `points` points. Returns the request's generation.
+  uint32_t request(uint32_t records, uint32_t offset, uint16_t points);
+  // Copy the latest published view into out if it is newer; true if it changed
+  bool take(HistoryView &out);
+  // Without a background task: read up to budget records on this thread
+  void poll(uint32_t budget);
+  // Records stored when the current request was started
+  uint32_t total() const { return totalRecords; }
+
+private:
+  static const uint16_t REFINE_BATCH = 16;
+  static const uint16_t CHUNK = 32;
+
+  enum class Phase : uint8_t
+  {
+    Idle,
+    Coarse,
+    Fine
+  };
+
+  // Sums of one whole bucket; bucket is the bucket's index + 1, 0 when unused
+  struct BucketSummary
+  {
+    uint32_t bucket;
+    uint32_t timestamp; // of the bucket's first record
+    int32_t tempSum;
+    uint32_t humSum;
+    uint8_t tempCount;
+    uint8_t humCount;
+  };
+
+  struct Request
+  {
+    uint32_t records;
+    uint32_t offset;
+    uint16_t points;
+  };
+
+  // Returns true while the current request has work left
+  bool step(uint32_t budget);
+  void start();
+  void publish();
+  // Add a cached bucket to the point's sums; false on a miss or a stale entry
+  bool addCached(uint32_t bucket);
+  void lock();
+  void unlock();
+
+  Fetch fetch;
+  Count count;
+
+  // Shared between the UI thread and the loader
+  Request pending = {0, 0, 0};
+  uint32_t requested = 0;
+  uint32_t publishedGen = 0;
+  uint32_t publishedVersion = 0;
+  HistoryView published;
+
+  // UI thread only, in take()
+  uint32_t takenVersion = 0;
+
+  // Written by the loader; total() reads it from the UI thread
+  volatile uint32_t totalRecords = 0;
+
+  // Loader thread only
+  uint32_t working = 0;
+  uint32_t version = 0;
+  Phase phase = Phase::Idle;
+  HistoryView view;
+  uint32_t end = 0;
+  uint16_t point = 0;
+  uint32_t pos = 0;
+  int32_t tempSum = 0;
+  uint32_t tempCount = 0;
+  uint32_t humSum = 0;
+  uint32_t humCount = 0;
+  BucketSummary bucketSums = {}; // the bucket being read, while it was read from its start
+  LogRecord chunk[CHUNK];
+  BucketSummary cache[HISTORY_CACHE_BUCKETS] = {};
+
+#if defined(ARDUINO_ARCH_ESP32)
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+  TaskHandle_t task = nullptr;
+  static void taskMain(void *arg);
+#endif
+};
@@ -0,0 +1,166 @@
+#include "HistoryReader.h"
+
+#if !defined(ARDUINO_ARCH_ESP32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+HistoryReader::~HistoryReader()
+{
+  close();
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+bool HistoryReader::open(const esp_partition_t *partition)
+{
+  close();
+  if (!partition)
+    return false;
+
+  const void *ptr = nullptr;
+  if (esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &ptr, &handle) != ESP_OK)
+    return false;
+  base = (const uint8_t *)ptr;
+  mapSize = partition->size;
+  sectorSize = SPI_FLASH_SEC_SIZE;
+  return refresh();
+}
+
+void HistoryReader::close()
+{
+  if (base)
+    spi_flash_munmap(handle);
+  base = nullptr;
+  handle = 0;
+  mapSize = 0;
+  blocks = 0;
+  total = 0;
+}
+#else
+bool HistoryReader::open(const char *imagePath, size_t sectorBytes)
+{
+  close();
+  fd = ::open(imagePath, O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close();
+    return false;
+  }
+  void *ptr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED)
+  {
+    close();
+    return false;
+  }
+  base = (const uint8_t *)ptr;
+  mapSize = (size_t)st.st_size;
+  sectorSize = sectorBytes;
+  return refresh();
+}
+
+void HistoryReader::close()
+{
+  if (base)
+    munmap((void *)base, mapSize);
+  if (fd >= 0)
+    ::close(fd);
+  base = nullptr;
+  fd = -1;
+  mapSize = 0;
+  blocks = 0;
+  total = 0;
+}
+#endif
+
+bool HistoryReader::refresh()
+{
+  blocks = 0;
+  total = 0;
+  if (!base)
+    return false;
+  sectors = mapSize / sectorSize;
+  rps = (sectorSize - FlashRingLog::HEADER_SIZE) / sizeof(LogRecord);
+  if (sectors < 2)
+    return false;
+
+  // Same recovery rule as FlashRingLog::begin(): newest sequence is the head,
+  // then walk back while sequence numbers stay contiguous
+  size_t head = 0;
+  uint32_t headSeq = 0;
+  bool found = false;
+  for (size_t i = 0; i < sectors; i++)
+  {
+    const FlashRingLog::SectorHeader *h = header(i);
+    if (!FlashRingLog::isValidHeader(*h))
+      continue;
+    if (!found || (int32_t)(h->sequence - headSeq) > 0)
+    {
+      head = i;
+      headSeq = h->sequence;
+      found = true;
+    }
+  }
+  if (!found)
+    return true; // Valid but empty
+
+  tail = head;
+  blocks = 1;
+  for (size_t k = 1; k < sectors; k++)
+  {
+    size_t prev = (head + sectors - k) % sectors;
+    const FlashRingLog::SectorHeader *h = header(prev);
+    if (!FlashRingLog::isValidHeader(*h) || h->sequence != headSeq - k)
+      break;
+    tail = prev;
+    blocks++;
+  }
+
+  // Binary search the first empty slot directly in mapped memory
+  const LogRecord *recs = records(head);
+  uint32_t lo = 0, hi = rps;
+  while (lo < hi)
+  {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (isLogRecordEmpty(recs[mid]))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  headFill = lo;
+  total = (uint32_t)(blocks - 1) * rps + headFill;
+  return true;
+}
+
+RecordSpan HistoryReader::block(size_t i) const
+{
+  if (i >= blocks)
+    return RecordSpan{nullptr, 0};
+  size_t sector = (tail + i) % sectors;
+  return RecordSpan{records(sector), i + 1 == blocks ? headFill : rps};
+}
+
+RecordSpan HistoryReader::spanAt(uint32_t index, size_t max) const
+{
+  if (rps == 0 || index >= total)
+    return RecordSpan{nullptr, 0};
+  RecordSpan span = block(index / rps);
+  size_t skip = index % rps;
+  size_t n = span.size - skip;
+  return RecordSpan{span.data + skip, n < max ? n : max};
+}
+
+const FlashRingLog::SectorHeader *HistoryReader::header(size_t sector) const
+{
+  return (const FlashRingLog::SectorHeader *)(base + sector * sectorSize);
+}
+
+const LogRecord *HistoryReader::records(size_t sector) const
+{
+  return (const LogRecord *)(base + sector * sectorSize + FlashRingLog::HEADER_SIZE);
+}
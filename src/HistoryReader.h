@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FlashRingLog.h"
+#include "LogRecord.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_partition.h>
+#endif
+
+// A run of records living directly in mapped flash; never copied
+struct RecordSpan
+{
+  const LogRecord *data;
+  size_t size;
+
+  const LogRecord *begin() const { return data; }
+  const LogRecord *end() const { return data + size; }
+  bool empty() const { return size == 0; }
+};
+
+/**
+ * Read-only, zero-copy view of a FlashRingLog partition.
+ *
+ * The whole partition is memory mapped once (esp_partition_mmap on the
+ * device, mmap() of a partition image file on the host) and every block
+ * (one flash sector) is exposed as a RecordSpan pointing straight into the
+ * mapping. Chart and export code iterate records in place instead of copying
+ * them into RAM buffers through FlashRingLog::read().
+ *
+ * Only programmed records are visible: call FlashRingLog::flush() and then
+ * refresh() to see the writer's latest appends.
+ */
+class HistoryReader
+{
+public:
+  HistoryReader() = default;
+  ~HistoryReader();
+  HistoryReader(const HistoryReader &) = delete;
+  HistoryReader &operator=(const HistoryReader &) = delete;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  bool open(const esp_partition_t *partition);
+#else
+  bool open(const char *imagePath, size_t sectorSize = 4096);
+#endif
+  void close();
+  bool isOpen() const { return base != nullptr; }
+
+  // Re-scan sector headers after the writer has appended/rotated
+  bool refresh();
+
+  // Blocks in chronological order: 0 is the oldest sector
+  size_t blockCount() const { return blocks; }
+  RecordSpan block(size_t i) const;
+  uint32_t count() const { return total; }
+  // Contiguous run of up to max records starting at a logical index (never crosses a block)
+  RecordSpan spanAt(uint32_t index, size_t max) const;
+
+  // Visit every record oldest-first; fn(const LogRecord &) returns false to stop early
+  template <typename Fn>
+  void forEach(Fn fn) const
+  {
+    for (size_t b = 0; b < blocks; b++)
+    {
+      RecordSpan span = block(b);
+      for (const LogRecord &rec : span)
+        if (!fn(rec))
+          return;
+    }
+  }
+
+  // Visit records from a logical index (0 = oldest) without touching earlier blocks
+  template <typename Fn>
+  void forEachFrom(uint32_t index, Fn fn) const
+  {
+    if (rps == 0)
+      return;
+    for (size_t b = index / rps; b < blocks; b++)
+    {
+      RecordSpan span = block(b);
+      size_t skip = (b == index / rps) ? index % rps : 0;
+      for (size_t i = skip; i < span.size; i++)
+        if (!fn(span.data[i]))
+          return;
+    }
+  }
+
+private:
+  const FlashRingLog::SectorHeader *header(size_t sector) const;
+  const LogRecord *records(size_t sector) const;
+
+  const uint8_t *base = nullptr;
+  size_t mapSize = 0;
+  size_t sectorSize = 4096;
+  size_t sectors = 0;
+  uint32_t rps = 0;
+
+  size_t tail = 0;
+  size_t blocks = 0;
+  uint32_t headFill = 0;
+  uint32_t total = 0;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  spi_flash_mmap_handle_t handle = 0;
+#else
+  int fd = -1;
+#endif
+};
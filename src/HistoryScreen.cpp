@@ -0,0 +1,227 @@
+#include "HistoryScreen.h"
+#include <stdio.h>
+#include "Theme.h"
+#include "TrendChart.h"
+
+const uint32_t HistoryScreen::ZOOM_MINUTES[ZOOM_LEVELS] = {60, 6 * 60, 24 * 60, 7 * 24 * 60, 30 * 24 * 60};
+
+namespace
+{
+  // Records polled per timer tick when there is no background task (host builds)
+  const uint32_t POLL_BUDGET = 2048;
+
+  void formatDuration(char *buf, size_t size, uint32_t minutes)
+  {
+    if (minutes < 120)
+      snprintf(buf, size, "%lu min", (unsigned long)minutes);
+    else if (minutes < 48 * 60)
+      snprintf(buf, size, "%lu h", (unsigned long)(minutes / 60));
+    else
+      snprintf(buf, size, "%lu d", (unsigned long)(minutes / (24 * 60)));
+  }
+
+  lv_obj_t *createButton(lv_obj_t *parent, const char *symbol, lv_event_cb_t cb, void *user)
+  {
+    lv_obj_t *btn = lv_btn_create(parent);
+    lv_obj_set_size(btn, 40, 32);
+    lv_obj_add_event_cb(btn, cb, LV_EVENT_CLICKED, user);
+    lv_obj_t *label = lv_label_create(btn);
+    lv_label_set_text(label, symbol);
+    lv_obj_center(label);
+    return btn;
+  }
+}
+
+void HistoryScreen::show(HistoryLoader &source)
+{
+  loader = &source;
+  if (screen)
+    requestView();
+}
+
+void HistoryScreen::released()
+{
+  lv_timer_del(timer);
+  timer = nullptr;
+  screen = chart = spanLabel = statusLabel = zoomOut = zoomIn = nullptr;
+  temp = humidity = nullptr;
+  view.points = 0;
+}
+
+lv_obj_t *HistoryScreen::build()
+{
+  screen = lv_obj_create(NULL);
+  lv_obj_add_style(screen, Theme::screen(), 0);
+  lv_obj_add_style(screen, Theme::spacing(), 0);
+  lv_obj_clear_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_layout(screen, LV_LAYOUT_FLEX);
+  lv_obj_set_flex_flow(screen, LV_FLEX_FLOW_COLUMN);
+
+  // Toolbar: back, span, zoom out/in
+  lv_obj_t *bar = lv_obj_create(screen);
+  lv_obj_set_size(bar, lv_pct(100), LV_SIZE_CONTENT);
+  lv_obj_add_style(bar, Theme::bare(), 0);
+  lv_obj_clear_flag(bar, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_layout(bar, LV_LAYOUT_FLEX);
+  lv_obj_set_flex_flow(bar, LV_FLEX_FLOW_ROW);
+  lv_obj_set_flex_align(bar, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+
+  createButton(bar, LV_SYMBOL_LEFT, onBack, this);
+  spanLabel = lv_label_create(bar);
+  lv_obj_set_flex_grow(spanLabel, 1);
+  lv_obj_add_style(spanLabel, Theme::text(), 0);
+  zoomOut = createButton(bar, LV_SYMBOL_MINUS, onZoom, this);
+  zoomIn = createButton(bar, LV_SYMBOL_PLUS, onZoom, this);
+
+  chart = lv_chart_create(screen);
+  lv_obj_set_width(chart, lv_pct(100));
+  lv_obj_set_flex_grow(chart, 1);
+  lv_obj_clear_flag(chart, LV_OBJ_FLAG_SCROLLABLE);
+  lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+  lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, TREND_TEMP_MIN, TREND_TEMP_MAX);
+  lv_chart_set_range(chart, LV_CHART_AXIS_SECONDARY_Y, TREND_HUMIDITY_MIN, TREND_HUMIDITY_MAX);
+  lv_chart_set_div_line_count(chart, 3, 0);
+  lv_chart_set_point_count(chart, 0);
+  Theme::applyChart(chart);
+  temp = lv_chart_add_series(chart, lv_color_hex(0xFF8C00), LV_CHART_AXIS_PRIMARY_Y);
+  humidity = lv_chart_add_series(chart, lv_color_hex(0x00B4FF), LV_CHART_AXIS_SECONDARY_Y);
+  lv_obj_add_event_cb(chart, onDrag, LV_EVENT_PRESSING, this);
+  lv_obj_add_event_cb(chart, onDrag, LV_EVENT_RELEASED, this);
+
+  statusLabel = lv_label_create(screen);
+  lv_obj_add_style(statusLabel, Theme::mutedText(), 0);
+  lv_label_set_text(statusLabel, "");
+
+  // Picks up loader results (and drives the loader on hosts without a task);
+  // paused while another screen is loaded
+  timer = lv_timer_create(onTimer, 50, this);
+  lv_timer_pause(timer);
+  lv_obj_add_event_cb(screen, onLoaded, LV_EVENT_SCREEN_LOADED, this);
+  lv_obj_add_event_cb(screen, onLoaded, LV_EVENT_SCREEN_UNLOADED, this);
+  return screen;
+}
+
+uint32_t HistoryScreen::spanRecords() const
+{
+  return (uint32_t)((uint64_t)ZOOM_MINUTES[zoom] * 60000 / LOG_INTERVAL_MS);
+}
+
+void HistoryScreen::requestView()
+{
+  // Width is only known once the flex layout has run
+  lv_obj_update_layout(screen);
+  lv_coord_t width = lv_obj_get_content_width(chart);
+  uint16_t points = width > 4 ? (uint16_t)(width / 2) : 2;
+  loader->request(spanRecords(), offset, points);
+
+  if (zoom + 1 < ZOOM_LEVELS)
+    lv_obj_clear_state(zoomOut, LV_STATE_DISABLED);
+  else
+    lv_obj_add_state(zoomOut, LV_STATE_DISABLED);
+  if (zoom > 0)
+    lv_obj_clear_state(zoomIn, LV_STATE_DISABLED);
+  else
+    lv_obj_add_state(zoomIn, LV_STATE_DISABLED);
+  updateSpanLabel();
+  lv_label_set_text(statusLabel, "Loading...");
+}
+
+void HistoryScreen::updateSpanLabel()
+{
+  char span[16];
+  formatDuration(span, sizeof(span), ZOOM_MINUTES[zoom]);
+  if (!offset)
+  {
+    lv_label_set_text_fmt(spanLabel, "Last %s", span);
+    return;
+  }
+  char ago[16];
+  formatDuration(ago, sizeof(ago), (uint32_t)((uint64_t)offset * LOG_INTERVAL_MS / 60000));
+  lv_label_set_text_fmt(spanLabel, "%s, %s ago", span, ago);
+}
+
+void HistoryScreen::showView()
+{
+  if (!view.points)
+  {
+    lv_chart_set_point_count(chart, 0);
+    lv_label_set_text(statusLabel, "No readings in this period");
+    return;
+  }
+
+  lv_chart_set_point_count(chart, view.points);
+  lv_coord_t *temps = lv_chart_get_y_array(chart, temp);
+  lv_coord_t *hums = lv_chart_get_y_array(chart, humidity);
+  for (uint16_t i = 0; i < view.points; i++)
+  {
+    temps[i] = view.temperature[i] == LOG_TEMP_INVALID ? LV_CHART_POINT_NONE : view.temperature[i];
+    hums[i] = view.humidity[i] == LOG_HUMIDITY_INVALID ? LV_CHART_POINT_NONE : (lv_coord_t)view.humidity[i];
+  }
+  lv_chart_refresh(chart);
+
+  if (view.complete())
+    lv_label_set_text(statusLabel, "");
+  else
+    lv_label_set_text_fmt(statusLabel, "Refining... %u%%", (unsigned)(view.refinedPoints * 100u / view.points));
+}
+
+void HistoryScreen::onBack(lv_event_t *e)
+{
+  static_cast<HistoryScreen *>(lv_event_get_user_data(e))->screens.back();
+}
+
+void HistoryScreen::onZoom(lv_event_t *e)
+{
+  auto *self = static_cast<HistoryScreen *>(lv_event_get_user_data(e));
+  lv_obj_t *btn = lv_event_get_target(e);
+  if (btn == self->zoomIn && self->zoom > 0)
+    self->zoom--;
+  else if (btn == self->zoomOut && self->zoom + 1 < ZOOM_LEVELS)
+    self->zoom++;
+  else
+    return;
+  self->requestView();
+}
+
+void HistoryScreen::onDrag(lv_event_t *e)
+{
+  auto *self = static_cast<HistoryScreen *>(lv_event_get_user_data(e));
+  if (lv_event_get_code(e) == LV_EVENT_PRESSING)
+  {
+    lv_point_t v;
+    lv_indev_get_vect(lv_indev_get_act(), &v);
+    self->dragPx += v.x;
+    return;
+  }
+  if (!self->dragPx)
+    return;
+
+  // Dragging right shows older readings
+  lv_coord_t width = lv_obj_get_content_width(self->chart);
+  int64_t moved = (int64_t)self->dragPx * self->spanRecords() / (width > 0 ? width : 1);
+  self->dragPx = 0;
+  int64_t next = (int64_t)self->offset + moved;
+  uint32_t total = self->loader->total();
+  int64_t oldest = total > self->spanRecords() ? total - self->spanRecords() : 0;
+  self->offset = (uint32_t)(next < 0 ? 0 : next > oldest ? oldest : next);
+  self->requestView();
+}
+
+void HistoryScreen::onLoaded(lv_event_t *e)
+{
+  auto *self = static_cast<HistoryScreen *>(lv_event_get_user_data(e));
+  if (lv_event_get_code(e) == LV_EVENT_SCREEN_LOADED)
+    lv_timer_resume(self->timer);
+  else
+    lv_timer_pause(self->timer);
+}
+
+void HistoryScreen::onTimer(lv_timer_t *timer)
+{
+  auto *self = static_cast<HistoryScreen *>(timer->user_data);
+  if (!self->loader)
+    return;
+  self->loader->poll(POLL_BUDGET);
+  if (self->loader->take(self->view))
+    self->showView();
+}
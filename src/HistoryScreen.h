@@ -0,0 +1,65 @@
+#pragma once
+
+#include <lvgl.h>
+#include "HistoryLoader.h"
+#include "ScreenManager.h"
+
+/**
+ * Zoomable history chart, from one hour to 30 days.
+ *
+ * The view asks HistoryLoader for one point per two pixels of chart width,
+ * so every zoom level costs the same to draw and hold; only the window on
+ * screen is read. The coarse view appears first and refines in place while
+ * the loader works in the background.
+ *
+ * Zoom with the -/+ buttons, drag the chart sideways to pan back in time.
+ * LVGL 8's pointer input is single-touch, so there is no pinch gesture.
+ *
+ * The screen is one of ScreenManager's: build() and released() are its
+ * hooks, and back returns to the previous screen. Zoom and pan survive an
+ * eviction; the polling timer only runs while the screen is loaded.
+ */
+class HistoryScreen
+{
+public:
+  explicit HistoryScreen(ScreenManager &screens) : screens(screens) {}
+
+  // ScreenManager hooks
+  lv_obj_t *build();
+  void released();
+  // Call after each ScreenManager::show(); reloads the window, the last view stays up meanwhile
+  void show(HistoryLoader &loader);
+
+private:
+  static const uint8_t ZOOM_LEVELS = 5;
+  static const uint32_t ZOOM_MINUTES[ZOOM_LEVELS];
+
+  void requestView();
+  void showView();
+  void updateSpanLabel();
+  uint32_t spanRecords() const;
+
+  static void onBack(lv_event_t *e);
+  static void onZoom(lv_event_t *e);
+  static void onDrag(lv_event_t *e);
+  static void onLoaded(lv_event_t *e);
+  static void onTimer(lv_timer_t *timer);
+
+  ScreenManager &screens;
+  HistoryLoader *loader = nullptr;
+  lv_obj_t *screen = nullptr;
+  lv_obj_t *chart = nullptr;
+  lv_obj_t *spanLabel = nullptr;
+  lv_obj_t *statusLabel = nullptr;
+  lv_obj_t *zoomOut = nullptr;
+  lv_obj_t *zoomIn = nullptr;
+  lv_chart_series_t *temp = nullptr;
+  lv_chart_series_t *humidity = nullptr;
+  lv_timer_t *timer = nullptr;
+
+  HistoryView view;
+  uint8_t zoom = 1;
+  // Records between the end of the window and the newest record
+  uint32_t offset = 0;
+  lv_coord_t dragPx = 0;
+};
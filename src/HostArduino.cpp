@@ -0,0 +1,31 @@
+#include "HostArduino.h"
+
+#if !defined(ARDUINO)
+
+#include <chrono>
+
+Print Serial;
+
+namespace
+{
+  uint32_t simulatedMs = 0;
+  const auto startTime = std::chrono::steady_clock::now();
+}
+
+uint32_t millis(void)
+{
+  return simulatedMs;
+}
+
+uint32_t micros(void)
+{
+  auto elapsed = std::chrono::steady_clock::now() - startTime;
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void hostTickAdvance(uint32_t ms)
+{
+  simulatedMs += ms;
+}
+
+#endif // !ARDUINO
@@ -0,0 +1,44 @@
+#pragma once
+
+#if !defined(ARDUINO)
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "HostTick.h"
+
+/**
+ * The handful of Arduino/ESP-IDF facilities TemplateCode uses, for host
+ * builds. Only what the display path needs; sensors, storage and the RGB
+ * LED stay firmware-only.
+ */
+
+// Serial output goes to stdout
+class Print
+{
+public:
+  size_t print(const char *text) { return (size_t)fputs(text, stdout); }
+  size_t println(const char *text) { return print(text) + print("\n"); }
+  size_t println() { return print("\n"); }
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+  {
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n > 0 ? (size_t)n : 0;
+  }
+  void flush() { fflush(stdout); }
+};
+
+extern Print Serial;
+
+// heap_caps: every host allocation is "DMA-capable internal RAM"
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+inline void *heap_caps_malloc(size_t size, uint32_t /* caps */) { return malloc(size); }
+inline void heap_caps_free(void *ptr) { free(ptr); }
+
+#endif // !ARDUINO
@@ -0,0 +1,112 @@
+#include "HostDisplay.h"
+
+#if !defined(ARDUINO)
+
+#include <stdio.h>
+
+HostDisplay::HostDisplay(uint16_t width, uint16_t height)
+    : panelWidth(width), panelHeight(height), fbWidth(width), fbHeight(height), fb((size_t)width * height, 0)
+{
+}
+
+bool HostDisplay::begin(uint8_t rotation, bool swapBytes)
+{
+  swap = swapBytes;
+  setRotation(rotation);
+  return true;
+}
+
+void HostDisplay::setRotation(uint8_t rotation)
+{
+  // Constructed with the native panel resolution; odd rotations swap the axes
+  bool quarter = (rotation & 1) != 0;
+  fbWidth = quarter ? panelHeight : panelWidth;
+  fbHeight = quarter ? panelWidth : panelHeight;
+  fb.assign((size_t)fbWidth * fbHeight, 0);
+}
+
+void HostDisplay::pushPixels(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *pixels)
+{
+  for (int32_t row = 0; row < h; row++)
+  {
+    int32_t py = y + row;
+    if (py < 0 || py >= fbHeight)
+      continue;
+    for (int32_t col = 0; col < w; col++)
+    {
+      int32_t px = x + col;
+      if (px < 0 || px >= fbWidth)
+        continue;
+      uint16_t c = pixels[(size_t)row * w + col];
+      // Panel-order input (LV_COLOR_16_SWAP) is stored back in native order
+      if (!swap)
+        c = (uint16_t)(c << 8 | c >> 8);
+      fb[(size_t)py * fbWidth + px] = c;
+    }
+  }
+}
+
+namespace
+{
+  // Expand 5/6/5 to 8 bits per channel by replicating the top bits
+  void toRGB888(uint16_t c, uint8_t *out)
+  {
+    uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+    out[0] = (uint8_t)(r << 3 | r >> 2);
+    out[1] = (uint8_t)(g << 2 | g >> 4);
+    out[2] = (uint8_t)(b << 3 | b >> 2);
+  }
+}
+
+bool HostDisplay::savePPM(const char *path) const
+{
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  fprintf(f, "P6\n%u %u\n255\n", (unsigned)fbWidth, (unsigned)fbHeight);
+  std::vector<uint8_t> row((size_t)fbWidth * 3);
+  bool ok = true;
+  for (uint16_t y = 0; y < fbHeight && ok; y++)
+  {
+    for (uint16_t x = 0; x < fbWidth; x++)
+      toRGB888(pixel(x, y), &row[x * 3]);
+    ok = fwrite(row.data(), 1, row.size(), f) == row.size();
+  }
+  return fclose(f) == 0 && ok;
+}
+
+long HostDisplay::diffPPM(const char *path) const
+{
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return -1;
+  unsigned w = 0, h = 0, maxval = 0;
+  if (fscanf(f, "P6 %u %u %u", &w, &h, &maxval) != 3 || fgetc(f) == EOF ||
+      w != fbWidth || h != fbHeight || maxval != 255)
+  {
+    fclose(f);
+    return -1;
+  }
+
+  std::vector<uint8_t> row((size_t)fbWidth * 3);
+  long differing = 0;
+  for (uint16_t y = 0; y < fbHeight; y++)
+  {
+    if (fread(row.data(), 1, row.size(), f) != row.size())
+    {
+      fclose(f);
+      return -1;
+    }
+    for (uint16_t x = 0; x < fbWidth; x++)
+    {
+      uint8_t rgb[3];
+      toRGB888(pixel(x, y), rgb);
+      if (rgb[0] != row[x * 3] || rgb[1] != row[x * 3 + 1] || rgb[2] != row[x * 3 + 2])
+        differing++;
+    }
+  }
+  fclose(f);
+  return differing;
+}
+
+#endif // !ARDUINO
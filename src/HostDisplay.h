@@ -0,0 +1,44 @@
+#pragma once
+
+#if !defined(ARDUINO)
+
+#include <vector>
+#include "DisplayHAL.h"
+
+/**
+ * Host backend: an in-memory RGB565 framebuffer standing in for the panel.
+ *
+ * The framebuffer always holds native-endian RGB565 regardless of the
+ * swapBytes setting, so it can be inspected or dumped directly.
+ */
+class HostDisplay : public DisplayHAL
+{
+public:
+  HostDisplay(uint16_t width, uint16_t height);
+
+  bool begin(uint8_t rotation, bool swapBytes) override;
+  void setRotation(uint8_t rotation) override;
+  void pushPixels(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *pixels) override;
+  bool transferDone() override { return true; }
+  void waitTransfer() override {}
+
+  uint16_t width() const { return fbWidth; }
+  uint16_t height() const { return fbHeight; }
+  const uint16_t *framebuffer() const { return fb.data(); }
+  uint16_t pixel(int32_t x, int32_t y) const { return fb[(size_t)y * fbWidth + x]; }
+  // Write the framebuffer as a binary PPM (P6, 8 bits per channel)
+  bool savePPM(const char *path) const;
+  // Number of pixels that differ from a PPM written by savePPM(); -1 if the
+  // file is missing, unreadable or a different size
+  long diffPPM(const char *path) const;
+
+private:
+  uint16_t panelWidth;
+  uint16_t panelHeight;
+  uint16_t fbWidth;
+  uint16_t fbHeight;
+  bool swap = false;
+  std::vector<uint16_t> fb;
+};
+
+#endif // !ARDUINO
@@ -0,0 +1,222 @@
+/**
+ * Headless host entry point ([env:native]).
+ *
+ * Runs TemplateCode and MainInterface on the desktop: LVGL renders into
+ * HostDisplay's in-memory framebuffer on a simulated clock. Useful for
+ * profiling UI code and checking layouts without a board. Pass/fail checks
+ * live in test/ and run with `pio test -e native`.
+ *
+ * Usage: program [--ms N] [--touch X,Y] [--rotation R] [--out frame.ppm]
+ *        program --suite DIR [--update] [--time-tolerance PCT]
+ *        program --benchmark
+ *        program --style-check
+ *        program --screen-switches N
+ *        program --events N
+ *
+ * --suite renders every UiSuite scenario and prints how its frames and pixel
+ * costs compare with the baseline in DIR; --update records a new baseline
+ * (test/ui-golden, gated by test/test_ui_suite). --time-tolerance only sets
+ * when a scenario is reported slower.
+ * --rotation switches orientation at runtime after the main screen is built.
+ * --screen-switches alternates between the main and history screens (30 days
+ * of synthetic readings) and prints the ScreenManager report.
+ * --events fills the event log with N synthetic events, opens the event list
+ * and scrolls it end to end at one step per touch read, then prints how many
+ * rows were rebound and the render stats of the scroll.
+ */
+
+// Unit test builds (pio test -e native) bring their own main()
+#if !defined(ARDUINO) && !defined(PIO_UNIT_TESTING)
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "TemplateCode.h"
+#include "MainInterface.h"
+#include "UiSuite.h"
+#include "DisplayBenchmark.h"
+#include "StyleCheck.h"
+#include "EventLog.h"
+#include "LvglMemory.h"
+
+namespace
+{
+  // 30 days of readings, one per LOG_INTERVAL_MS, generated on demand
+  const uint32_t SYNTHETIC_RECORDS = (uint32_t)(30ULL * 86400000 / LOG_INTERVAL_MS);
+
+  size_t fetchSynthetic(uint32_t index, LogRecord *out, size_t max)
+  {
+    size_t n = 0;
+    for (; n < max && index + n < SYNTHETIC_RECORDS; n++)
+    {
+      float t = (float)(index + n);
+      out[n] = makeLogRecord((uint32_t)(t * LOG_INTERVAL_MS / 1000), 20.0f + 6.0f * sinf(t * 0.0044f),
+                             50.0f + 15.0f * cosf(t * 0.0007f));
+    }
+    return n;
+  }
+
+  uint32_t countSynthetic() { return SYNTHETIC_RECORDS; }
+
+  // Readings swinging across the alert thresholds, with sensor faults and a
+  // restart every three days
+  void fillSyntheticEvents(EventLog &log, uint32_t events)
+  {
+    for (uint32_t i = 0; log.raised() < events; i++)
+    {
+      float t = 17.5f + 15.0f * sinf(i * 0.05f);
+      float h = 55.0f + 30.0f * sinf(i * 0.031f);
+      log.observe(makeLogRecord(i * 60 % (3 * 86400), i % 97 == 0 ? NAN : t, h));
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t runMs = 1000;
+  const char *outPath = nullptr;
+  bool touch = false;
+  int touchX = 0, touchY = 0;
+  const char *suiteDir = nullptr;
+  bool updateBaseline = false;
+  long timeTolerance = -1;
+  bool benchmark = false;
+  int rotation = -1;
+  uint32_t screenSwitches = 0;
+  bool styleCheck = false;
+  uint32_t eventCount = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "--ms") && i + 1 < argc)
+      runMs = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--rotation") && i + 1 < argc)
+      rotation = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--out") && i + 1 < argc)
+      outPath = argv[++i];
+    else if (!strcmp(argv[i], "--touch") && i + 1 < argc)
+      touch = sscanf(argv[++i], "%d,%d", &touchX, &touchY) == 2;
+    else if (!strcmp(argv[i], "--suite") && i + 1 < argc)
+      suiteDir = argv[++i];
+    else if (!strcmp(argv[i], "--update"))
+      updateBaseline = true;
+    else if (!strcmp(argv[i], "--time-tolerance") && i + 1 < argc)
+      timeTolerance = strtol(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--screen-switches") && i + 1 < argc)
+      screenSwitches = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--events") && i + 1 < argc)
+      eventCount = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--style-check"))
+      styleCheck = true;
+    else if (!strcmp(argv[i], "--benchmark"))
+      benchmark = true;
+    else
+    {
+      fprintf(stderr, "usage: %s [--ms N] [--touch X,Y] [--rotation R] [--out frame.ppm]\n"
+                      "       %s --suite DIR [--update] [--time-tolerance PCT]\n"
+                      "       %s --benchmark\n"
+                      "       %s --style-check\n"
+                      "       %s --screen-switches N\n"
+                      "       %s --events N\n",
+              argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
+      return 2;
+    }
+  }
+
+  TemplateCode &templateCode = TemplateCode::getInstance();
+  if (!templateCode.begin())
+    return 1;
+
+  if (suiteDir)
+  {
+    UiSuite suite(templateCode, suiteDir);
+    if (timeTolerance >= 0)
+      suite.timeTolerancePct = (uint32_t)timeTolerance;
+    return suite.run(updateBaseline) ? 1 : 0;
+  }
+  if (benchmark)
+  {
+    DisplayBenchmark::run(templateCode);
+    return 0;
+  }
+  if (styleCheck)
+  {
+    StyleCheck::run(templateCode);
+    return 0;
+  }
+
+  MainInterface mainInterface;
+  mainInterface.init();
+  templateCode.setFrameListener(ScreenManager::frameListener, &mainInterface.screenManager());
+  mainInterface.setTemperature(21.5f);
+  mainInterface.setHumidity(48.0f);
+  if (rotation >= 0)
+  {
+    // Render once first, so the switch happens on a live screen
+    templateCode.advance(LV_DISP_DEF_REFR_PERIOD);
+    templateCode.setRotation((uint8_t)rotation);
+  }
+  if (screenSwitches)
+  {
+    static HistoryLoader loader(fetchSynthetic, countSynthetic);
+    mainInterface.setHistoryLoader(&loader);
+    for (uint32_t i = 0; i < screenSwitches; i++)
+    {
+      if (i & 1)
+        mainInterface.screenManager().back();
+      else
+        mainInterface.showHistory();
+      templateCode.advance(LV_DISP_DEF_REFR_PERIOD);
+    }
+    templateCode.waitForFlush();
+    mainInterface.screenManager().printReport(Serial);
+  }
+  if (eventCount)
+  {
+    static EventLog events;
+    fillSyntheticEvents(events, eventCount);
+    mainInterface.setEventLog(&events);
+    mainInterface.showEvents();
+    templateCode.advance(LV_DISP_DEF_REFR_PERIOD);
+    templateCode.waitForFlush();
+
+    // A steady drag: one scroll step per touch read until the oldest entry shows
+    const lv_coord_t STEP_PX = 16;
+    VirtualList &list = mainInterface.eventScreen().list();
+    templateCode.resetRenderStats();
+    uint32_t binds = list.binds();
+    uint32_t steps = 0;
+    for (; lv_obj_get_scroll_bottom(list.object()) > 0 && steps < 100000; steps++)
+    {
+      lv_obj_scroll_by(list.object(), 0, -STEP_PX, LV_ANIM_OFF);
+      templateCode.advance(LV_INDEV_DEF_READ_PERIOD);
+    }
+    templateCode.waitForFlush();
+    Serial.printf("Event list: %lu entries, scrolled to %lu in %lu steps, %lu rows rebound, LVGL live %lu B\n",
+                  (unsigned long)list.size(), (unsigned long)list.first(), (unsigned long)steps,
+                  (unsigned long)(list.binds() - binds), (unsigned long)LvglMemory::stats().liveBytes);
+    templateCode.printRenderStats(Serial);
+  }
+
+  Serial.printf("Full redraw: %lu us\n", (unsigned long)templateCode.measureFullRedraw());
+  templateCode.resetRenderStats();
+
+  if (touch)
+  {
+    templateCode.injectTouch(touchX, touchY, true);
+    templateCode.advance(100);
+    templateCode.injectTouch(touchX, touchY, false);
+  }
+  templateCode.advance(runMs);
+  templateCode.waitForFlush();
+
+  templateCode.printRenderStats(Serial);
+  if (outPath && !templateCode.hostDisplay().savePPM(outPath))
+  {
+    fprintf(stderr, "Could not write %s\n", outPath);
+    return 1;
+  }
+  return 0;
+}
+
+#endif // !ARDUINO && !PIO_UNIT_TESTING
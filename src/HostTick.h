@@ -0,0 +1,28 @@
+#pragma once
+
+#if !defined(ARDUINO)
+
+#include <stdint.h>
+
+/*
+ * Simulated clock for host builds. Included by LVGL's C sources through
+ * LV_TICK_CUSTOM_INCLUDE (lv_conf.h), so it must stay C-compatible.
+ *
+ * millis() only moves when the host program calls hostTickAdvance(), which
+ * keeps LVGL timers and animations deterministic from run to run. micros()
+ * reads the real monotonic clock so render cost can still be measured.
+ */
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  uint32_t millis(void);
+  uint32_t micros(void);
+  void hostTickAdvance(uint32_t ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // !ARDUINO
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Index math behind VirtualList, kept free of LVGL so it can be unit tested.
+ *
+ * Entries are rows of equal height. The scrollable window holds at most
+ * maxRows of them, starting at entry base; a row's position inside the
+ * window is its entry index minus base.
+ */
+struct ListWindow
+{
+  // Labels needed to cover a viewport of viewPx with a row entering at each edge
+  static uint32_t poolSize(int32_t viewPx, int32_t rowHeight, uint32_t maxPool)
+  {
+    uint32_t needed = viewPx > 0 ? (uint32_t)(viewPx / rowHeight) + 2 : 0;
+    return needed < maxPool ? needed : maxPool;
+  }
+
+  // Rows in the window starting at base
+  static uint32_t rows(uint32_t count, uint32_t base, uint32_t maxRows)
+  {
+    return count - base < maxRows ? count - base : maxRows;
+  }
+
+  // Base that puts entry first in the middle of the window, kept inside the list
+  static uint32_t centredBase(uint32_t first, uint32_t count, uint32_t maxRows)
+  {
+    uint32_t base = first > maxRows / 2 ? first - maxRows / 2 : 0;
+    if (base + maxRows > count)
+      base = count > maxRows ? count - maxRows : 0;
+    return base;
+  }
+
+  // Base to move to so the viewport (at topRow of the window, viewRows tall)
+  // stays clear of the window's ends; base itself if it already is
+  static uint32_t recentre(uint32_t base, uint32_t topRow, uint32_t viewRows, uint32_t count, uint32_t maxRows)
+  {
+    if (count <= maxRows)
+      return base;
+    bool nearStart = base > 0 && topRow < viewRows;
+    bool nearEnd = base + maxRows < count && topRow + 2 * viewRows > maxRows;
+    return nearStart || nearEnd ? centredBase(base + topRow, count, maxRows) : base;
+  }
+
+  // Row k always uses label k % poolSize: scrolling by one row rebinds one label
+  static uint8_t slot(uint32_t entry, uint8_t poolSize) { return (uint8_t)(entry % poolSize); }
+};
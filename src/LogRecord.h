@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * One persisted sensor sample.
+ *
+ * Values are stored as fixed-point tenths so a record is only 8 bytes, packs
+ * evenly into flash pages and SD sectors, and can be formatted without going
+ * through float printf. A timestamp of 0xFFFFFFFF is what erased NOR flash
+ * reads back as, so it doubles as the "empty slot" marker.
+ */
+struct LogRecord
+{
+  uint32_t timestamp;  // Seconds since boot (or epoch once the clock is set)
+  int16_t temperature; // 0.1 °C, LOG_TEMP_INVALID when the sensor read failed
+  uint16_t humidity;   // 0.1 %RH, LOG_HUMIDITY_INVALID when the sensor read failed
+};
+
+static_assert(sizeof(LogRecord) == 8, "LogRecord must stay 8 bytes to pack evenly into flash pages");
+
+// One record is logged per interval; history views use it to turn spans of
+// time into record counts
+#ifndef LOG_INTERVAL_MS
+#define LOG_INTERVAL_MS 60000
+#endif
+
+static const uint32_t LOG_TIMESTAMP_EMPTY = 0xFFFFFFFFu;
+static const int16_t LOG_TEMP_INVALID = INT16_MIN;
+static const uint16_t LOG_HUMIDITY_INVALID = 0xFFFF;
+
+// Build a record from the float values SensorManager reports
+inline LogRecord makeLogRecord(uint32_t timestamp, float tempC, float humidity)
+{
+  LogRecord rec;
+  rec.timestamp = timestamp;
+  rec.temperature = isnan(tempC) ? LOG_TEMP_INVALID : (int16_t)lroundf(tempC * 10.0f);
+  rec.humidity = isnan(humidity) ? LOG_HUMIDITY_INVALID : (uint16_t)lroundf(humidity * 10.0f);
+  return rec;
+}
+
+inline bool isLogRecordEmpty(const LogRecord &rec)
+{
+  return rec.timestamp == LOG_TIMESTAMP_EMPTY;
+}
@@ -0,0 +1,113 @@
+#include "LovyanDisplay.h"
+
+#if defined(DISPLAY_BACKEND_LOVYANGFX)
+
+#ifndef SPI_FREQUENCY
+#define SPI_FREQUENCY 40000000
+#endif
+#ifndef SPI_READ_FREQUENCY
+#define SPI_READ_FREQUENCY 16000000
+#endif
+
+LovyanDisplay::Device::Device()
+{
+  { // SPI bus configuration
+    auto cfg = bus.config();
+    cfg.spi_host = VSPI_HOST;
+    cfg.spi_mode = 0;
+    cfg.freq_write = SPI_FREQUENCY;
+    cfg.freq_read = SPI_READ_FREQUENCY;
+    cfg.spi_3wire = false;
+    cfg.use_lock = true;
+    cfg.dma_channel = 1;
+    cfg.pin_sclk = TFT_SCLK;
+    cfg.pin_mosi = TFT_MOSI;
+    cfg.pin_miso = -1; // Panel is write-only here
+    cfg.pin_dc = TFT_DC;
+    bus.config(cfg);
+    panel.setBus(&bus);
+  }
+
+  { // Display panel configuration (native 240x320 portrait)
+    auto cfg = panel.config();
+    cfg.pin_cs = TFT_CS;
+    cfg.pin_rst = TFT_RST;
+    cfg.pin_busy = -1;
+    cfg.panel_width = 240;
+    cfg.panel_height = 320;
+    cfg.offset_rotation = 0;
+    cfg.dummy_read_pixel = 8;
+    cfg.dummy_read_bits = 1;
+    cfg.readable = false;
+    cfg.invert = false;
+    cfg.rgb_order = 0;
+    cfg.dlen_16bit = false;
+    cfg.bus_shared = true; // Resistive touch shares VSPI
+    panel.config(cfg);
+  }
+
+  setPanel(&panel);
+}
+
+LovyanDisplay::LovyanDisplay(uint16_t width, uint16_t height)
+{
+  // Resolution follows from the panel config and rotation
+}
+
+bool LovyanDisplay::begin(uint8_t rotation, bool swapBytes)
+{
+  swap = swapBytes;
+  if (!lcd.init())
+    return false;
+  lcd.setRotation(rotation);
+#ifdef TFT_BL
+  pinMode(TFT_BL, OUTPUT);
+  digitalWrite(TFT_BL, TFT_BACKLIGHT_ON);
+#endif
+  return true;
+}
+
+void LovyanDisplay::setRotation(uint8_t rotation)
+{
+  waitTransfer();
+  lcd.setRotation(rotation);
+}
+
+void LovyanDisplay::pushPixels(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *pixels)
+{
+  // startWrite() nests in LovyanGFX and transferDone()/waitTransfer() end it
+  // once, so open the transaction only for the first push after a release
+  if (!writing)
+  {
+    lcd.startWrite();
+    writing = true;
+  }
+  // Pixel type tells LovyanGFX whether the data is already in panel byte order
+  if (swap)
+    lcd.pushImageDMA(x, y, w, h, (const lgfx::rgb565_t *)pixels);
+  else
+    lcd.pushImageDMA(x, y, w, h, (const lgfx::swap565_t *)pixels);
+}
+
+bool LovyanDisplay::transferDone()
+{
+  if (writing && lcd.dmaBusy())
+    return false;
+  if (writing)
+  {
+    lcd.endWrite();
+    writing = false;
+  }
+  return true;
+}
+
+void LovyanDisplay::waitTransfer()
+{
+  if (!writing)
+    return;
+  lcd.waitDMA();
+  lcd.endWrite();
+  writing = false;
+}
+
+#endif // DISPLAY_BACKEND_LOVYANGFX
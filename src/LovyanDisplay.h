@@ -0,0 +1,37 @@
+#pragma once
+
+#if defined(DISPLAY_BACKEND_LOVYANGFX)
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp> // https://github.com/lovyan03/LovyanGFX
+#include "DisplayHAL.h"
+
+// LovyanGFX backend for the CYD's ST7789 on VSPI; pins come from the same build flags as TFT_eSPI
+class LovyanDisplay : public DisplayHAL
+{
+public:
+  LovyanDisplay(uint16_t width, uint16_t height);
+
+  bool begin(uint8_t rotation, bool swapBytes) override;
+  void setRotation(uint8_t rotation) override;
+  void pushPixels(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *pixels) override;
+  bool transferDone() override;
+  void waitTransfer() override;
+
+private:
+  class Device : public lgfx::LGFX_Device
+  {
+  public:
+    Device();
+
+  private:
+    lgfx::Panel_ST7789 panel;
+    lgfx::Bus_SPI bus;
+  };
+
+  Device lcd;
+  bool swap = false;
+  bool writing = false;
+};
+
+#endif // DISPLAY_BACKEND_LOVYANGFX
@@ -0,0 +1,322 @@
+#include "LvglMemory.h"
+#include <stdlib.h>
+#include <string.h>
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include "HostArduino.h"
+#endif
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_heap_caps.h>
+#endif
+
+namespace
+{
+  struct Pool
+  {
+    uint8_t *base;
+    uint16_t slotSize;
+    uint16_t slots;
+    void *freeList; // free slots are chained through their first word
+  };
+
+  alignas(8) uint8_t arena16[16 * LVGL_POOL_SLOTS_16];
+  alignas(8) uint8_t arena32[32 * LVGL_POOL_SLOTS_32];
+  alignas(8) uint8_t arena64[64 * LVGL_POOL_SLOTS_64];
+  alignas(8) uint8_t arena128[128 * LVGL_POOL_SLOTS_128];
+
+  Pool pools[LvglMemStats::POOLS] = {
+      {arena16, 16, LVGL_POOL_SLOTS_16, nullptr},
+      {arena32, 32, LVGL_POOL_SLOTS_32, nullptr},
+      {arena64, 64, LVGL_POOL_SLOTS_64, nullptr},
+      {arena128, 128, LVGL_POOL_SLOTS_128, nullptr},
+  };
+
+  LvglMemStats memStats;
+  bool initialised = false;
+
+  // Heap blocks carry their requested size in front; 8 bytes keeps alignment
+  struct HeapHeader
+  {
+    uint32_t size;
+    uint32_t magic;
+  };
+  const uint32_t HEAP_MAGIC = 0x4C564D48; // 'LVMH'
+
+#ifdef ARDUINO_ARCH_ESP32
+  void *systemAlloc(size_t size) { return malloc(size); }
+  void systemFree(void *ptr) { free(ptr); }
+#else
+  // Host heap: address-ordered blocks, each headed by its size (header
+  // included, a multiple of 8) and whether it is free. Free neighbours are
+  // merged as the list is walked.
+  struct ArenaBlock
+  {
+    uint32_t size;
+    uint32_t free;
+  };
+
+  alignas(8) uint8_t hostHeap[LVGL_HOST_HEAP_BYTES / 8 * 8];
+
+  ArenaBlock *nextBlock(ArenaBlock *b)
+  {
+    uint8_t *next = (uint8_t *)b + b->size;
+    return next < hostHeap + sizeof(hostHeap) ? (ArenaBlock *)next : nullptr;
+  }
+
+  void mergeFree(ArenaBlock *b)
+  {
+    for (ArenaBlock *n = nextBlock(b); n && n->free; n = nextBlock(b))
+      b->size += n->size;
+  }
+
+  void *systemAlloc(size_t size)
+  {
+    uint32_t need = (uint32_t)((sizeof(ArenaBlock) + size + 7) / 8 * 8);
+    for (ArenaBlock *b = (ArenaBlock *)hostHeap; b; b = nextBlock(b))
+    {
+      if (!b->free)
+        continue;
+      mergeFree(b);
+      if (b->size < need)
+        continue;
+      // Split unless the rest would be too small to hold anything
+      if (b->size - need >= 2 * sizeof(ArenaBlock))
+      {
+        auto *rest = (ArenaBlock *)((uint8_t *)b + need);
+        rest->size = b->size - need;
+        rest->free = 1;
+        b->size = need;
+      }
+      b->free = 0;
+      return b + 1;
+    }
+    return nullptr;
+  }
+
+  void systemFree(void *ptr)
+  {
+    auto *b = (ArenaBlock *)ptr - 1;
+    b->free = 1;
+    mergeFree(b);
+  }
+#endif
+
+  void init()
+  {
+    for (uint8_t i = 0; i < LvglMemStats::POOLS; i++)
+    {
+      Pool &pool = pools[i];
+      pool.freeList = nullptr;
+      for (int s = pool.slots - 1; s >= 0; s--)
+      {
+        void *slot = pool.base + (size_t)s * pool.slotSize;
+        *(void **)slot = pool.freeList;
+        pool.freeList = slot;
+      }
+      memStats.pools[i] = {pool.slotSize, pool.slots, 0, 0, 0};
+    }
+#ifndef ARDUINO_ARCH_ESP32
+    auto *all = (ArenaBlock *)hostHeap;
+    all->size = sizeof(hostHeap);
+    all->free = 1;
+#endif
+    initialised = true;
+  }
+
+  int poolOf(const void *ptr)
+  {
+    const uint8_t *p = (const uint8_t *)ptr;
+    for (uint8_t i = 0; i < LvglMemStats::POOLS; i++)
+      if (p >= pools[i].base && p < pools[i].base + (size_t)pools[i].slots * pools[i].slotSize)
+        return i;
+    return -1;
+  }
+
+  void held(uint32_t bytes)
+  {
+    memStats.liveBytes += bytes;
+    if (memStats.liveBytes > memStats.peakBytes)
+      memStats.peakBytes = memStats.liveBytes;
+  }
+
+  void *heapAlloc(size_t size)
+  {
+    auto *h = (HeapHeader *)systemAlloc(sizeof(HeapHeader) + size);
+    if (!h)
+      return nullptr;
+    h->size = (uint32_t)size;
+    h->magic = HEAP_MAGIC;
+    memStats.heapBlocks++;
+    memStats.heapLiveBytes += h->size;
+    if (memStats.heapLiveBytes > memStats.heapPeakBytes)
+      memStats.heapPeakBytes = memStats.heapLiveBytes;
+    held(h->size);
+    return h + 1;
+  }
+
+  HeapHeader *headerOf(void *ptr)
+  {
+    return (HeapHeader *)ptr - 1;
+  }
+}
+
+extern "C" void *lvglMemAlloc(size_t size)
+{
+  if (!initialised)
+    init();
+  memStats.allocs++;
+
+  for (uint8_t i = 0; i < LvglMemStats::POOLS; i++)
+  {
+    Pool &pool = pools[i];
+    if (size > pool.slotSize)
+      continue;
+    LvglPoolStats &ps = memStats.pools[i];
+    if (!pool.freeList)
+    {
+      // Full: count it and fall through to the heap rather than a bigger pool,
+      // so the overflow shows which class needs more slots
+      ps.overflows++;
+      break;
+    }
+    void *slot = pool.freeList;
+    pool.freeList = *(void **)slot;
+    if (++ps.used > ps.peak)
+      ps.peak = ps.used;
+    held(pool.slotSize);
+    return slot;
+  }
+
+  void *ptr = heapAlloc(size);
+  if (!ptr)
+    memStats.failures++;
+  return ptr;
+}
+
+extern "C" void lvglMemFree(void *ptr)
+{
+  if (!ptr)
+    return;
+  memStats.frees++;
+
+  int i = poolOf(ptr);
+  if (i >= 0)
+  {
+    *(void **)ptr = pools[i].freeList;
+    pools[i].freeList = ptr;
+    memStats.pools[i].used--;
+    memStats.liveBytes -= pools[i].slotSize;
+    return;
+  }
+
+  HeapHeader *h = headerOf(ptr);
+  memStats.heapBlocks--;
+  memStats.heapLiveBytes -= h->size;
+  memStats.liveBytes -= h->size;
+  h->magic = 0;
+  systemFree(h);
+}
+
+extern "C" void *lvglMemRealloc(void *ptr, size_t size)
+{
+  if (!ptr)
+    return lvglMemAlloc(size);
+
+  size_t oldSize;
+  int i = poolOf(ptr);
+  if (i >= 0)
+  {
+    // Still fits its slot: nothing to do
+    if (size <= pools[i].slotSize)
+      return ptr;
+    oldSize = pools[i].slotSize;
+  }
+  else
+  {
+    oldSize = headerOf(ptr)->size;
+  }
+
+  void *next = lvglMemAlloc(size);
+  if (!next)
+    return nullptr;
+  memcpy(next, ptr, oldSize < size ? oldSize : size);
+  lvglMemFree(ptr);
+  return next;
+}
+
+namespace LvglMemory
+{
+  const LvglMemStats &stats()
+  {
+    if (!initialised)
+      init();
+    return memStats;
+  }
+
+  void resetPeaks()
+  {
+    if (!initialised)
+      init();
+    for (uint8_t i = 0; i < LvglMemStats::POOLS; i++)
+    {
+      memStats.pools[i].peak = memStats.pools[i].used;
+      memStats.pools[i].overflows = 0;
+    }
+    memStats.heapPeakBytes = memStats.heapLiveBytes;
+    memStats.peakBytes = memStats.liveBytes;
+    memStats.allocs = memStats.frees = memStats.failures = 0;
+  }
+
+  uint8_t heapFragmentation()
+  {
+#ifdef ARDUINO_ARCH_ESP32
+    size_t freeBytes = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#else
+    if (!initialised)
+      init();
+    size_t freeBytes = 0;
+    size_t largest = 0;
+    for (ArenaBlock *b = (ArenaBlock *)hostHeap; b; b = nextBlock(b))
+    {
+      if (!b->free)
+        continue;
+      mergeFree(b);
+      freeBytes += b->size - sizeof(ArenaBlock);
+      if (b->size - sizeof(ArenaBlock) > largest)
+        largest = b->size - sizeof(ArenaBlock);
+    }
+#endif
+    return freeBytes ? (uint8_t)(100 - largest * 100 / freeBytes) : 0;
+  }
+
+  bool healthy()
+  {
+    const LvglMemStats &s = stats();
+    if (s.failures)
+      return false;
+    for (uint8_t i = 0; i < LvglMemStats::POOLS; i++)
+      if (s.pools[i].overflows)
+        return false;
+    return heapFragmentation() < LVGL_MEM_FRAG_WARN;
+  }
+
+  void printReport(Print &out)
+  {
+    const LvglMemStats &s = stats();
+    out.printf("LVGL memory: %lu B live, peak %lu B, %lu allocs, %lu frees, %lu failures\n",
+               (unsigned long)s.liveBytes, (unsigned long)s.peakBytes, (unsigned long)s.allocs,
+               (unsigned long)s.frees, (unsigned long)s.failures);
+    for (uint8_t i = 0; i < LvglMemStats::POOLS; i++)
+    {
+      const LvglPoolStats &p = s.pools[i];
+      out.printf("  pool %3u B: %3u/%3u used, peak %3u, overflows %lu\n", (unsigned)p.slotSize,
+                 (unsigned)p.used, (unsigned)p.slots, (unsigned)p.peak, (unsigned long)p.overflows);
+    }
+    out.printf("  heap: %lu blocks, %lu B live, peak %lu B, fragmentation %u%%\n",
+               (unsigned long)s.heapBlocks, (unsigned long)s.heapLiveBytes,
+               (unsigned long)s.heapPeakBytes, (unsigned)heapFragmentation());
+    out.printf("  status: %s\n", healthy() ? "ok" : "WARNING (failures, pool overflow or fragmentation)");
+  }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * LVGL allocator (LV_MEM_CUSTOM in lv_conf.h). Included by LVGL's C sources,
+ * so the allocator entry points stay C-compatible.
+ *
+ * Requests up to 128 bytes (most of LVGL's objects, styles and event
+ * descriptors) come from fixed-size slot pools, which cannot fragment.
+ * Larger requests, and small ones whose pool is full, go to the system heap.
+ * Every path is counted so a health report can show live and peak usage per
+ * pool, overflow into the heap, failures and heap fragmentation.
+ *
+ * Off the ESP32 the "heap" is a fixed first-fit arena of LVGL_HOST_HEAP_BYTES
+ * rather than malloc, so host runs (the memory soak) see the same kind of
+ * fragmentation the firmware's heap would and can measure it.
+ */
+
+/* Slots per size class (16, 32, 64, 128 bytes); overridable from build flags */
+#ifndef LVGL_POOL_SLOTS_16
+#define LVGL_POOL_SLOTS_16 256
+#endif
+#ifndef LVGL_POOL_SLOTS_32
+#define LVGL_POOL_SLOTS_32 256
+#endif
+#ifndef LVGL_POOL_SLOTS_64
+#define LVGL_POOL_SLOTS_64 128
+#endif
+#ifndef LVGL_POOL_SLOTS_128
+#define LVGL_POOL_SLOTS_128 64
+#endif
+
+/* Heap arena size on hosts, about the ESP32's free internal RAM */
+#ifndef LVGL_HOST_HEAP_BYTES
+#define LVGL_HOST_HEAP_BYTES (256 * 1024)
+#endif
+
+/* healthy() turns false above this heap fragmentation (percent) */
+#ifndef LVGL_MEM_FRAG_WARN
+#define LVGL_MEM_FRAG_WARN 50
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  void *lvglMemAlloc(size_t size);
+  void lvglMemFree(void *ptr);
+  void *lvglMemRealloc(void *ptr, size_t size);
+
+#ifdef __cplusplus
+}
+
+class Print;
+
+struct LvglPoolStats
+{
+  uint16_t slotSize;
+  uint16_t slots;
+  uint16_t used;
+  uint16_t peak;
+  uint32_t overflows; // requests that found the pool full and went to the heap
+};
+
+struct LvglMemStats
+{
+  static const uint8_t POOLS = 4;
+  LvglPoolStats pools[POOLS];
+  uint32_t heapLiveBytes; // requested bytes held in heap blocks
+  uint32_t heapPeakBytes;
+  uint32_t heapBlocks;
+  uint32_t liveBytes; // pool slots plus heap bytes currently held
+  uint32_t peakBytes;
+  uint32_t allocs;
+  uint32_t frees;
+  uint32_t failures;
+};
+
+namespace LvglMemory
+{
+  const LvglMemStats &stats();
+  // Zero the peaks and counters (live usage is kept)
+  void resetPeaks();
+  // Heap fragmentation, 0-100: 100 - largest free block / total free (the host arena's off the ESP32)
+  uint8_t heapFragmentation();
+  // False if anything has failed, a pool has overflowed, or the heap is badly fragmented
+  bool healthy();
+  void printReport(Print &out);
+}
+
+#endif
@@ -4,7 +4,8 @@
  *
  * Description:
  * Implements a simple scrollable interface with temperature display.
- * Optimized for portrait orientation (320x240).
+ * Sized relative to the display, so it lays itself out again in either
+ * orientation after TemplateCode::setRotation().
  *
  * LVGL Basics:
  * - lv_obj_t: Base type for all LVGL widgets
@@ -23,18 +24,25 @@
  */
 
 #include "MainInterface.h"
-#include <stdio.h>
+#include "FixedFormat.h"
+#include "Theme.h"
 
 /**
  * Constructor: Initializes all UI element pointers to nullptr
  * This prevents undefined behavior if accessed before initialization
  */
-MainInterface::MainInterface()
+MainInterface::MainInterface() : history(screens), events(screens)
 {
   mainScreen = nullptr;
   headerContainer = nullptr;
   headerLabel = nullptr;
   tempLabel = nullptr;
+  humidityLabel = nullptr;
+
+  // Registered only; nothing is built until a screen is first shown
+  mainId = screens.add({"main", buildMain, releaseMain, this, true});
+  historyId = screens.add({"history", buildHistory, releaseHistory, this, false});
+  eventsId = screens.add({"events", buildEvents, releaseEvents, this, false});
 }
 
 /**
@@ -48,18 +56,23 @@ MainInterface::~MainInterface()
 
 /**
  * Main initialization function
- * Creates and configures all UI elements in the proper hierarchy
+ * Builds the main screen (again, if it has been deleted) and shows it
  */
 void MainInterface::init()
 {
-  // Create main screen container
+  Theme::init();
+  screens.show(mainId);
+}
+
+/**
+ * Creates and configures all main screen elements in the proper hierarchy
+ */
+lv_obj_t *MainInterface::createMainScreen()
+{
+  // Create main screen container; screens always take the display's size
   mainScreen = lv_obj_create(NULL);
-  // Set portrait orientation (240x320)
-  lv_obj_set_size(mainScreen, 240, 320);
-  // Set dark theme background
-  lv_obj_set_style_bg_color(mainScreen, lv_color_hex(0x000000), LV_PART_MAIN);
-  // Remove default padding
-  lv_obj_set_style_pad_all(mainScreen, 0, 0);
+  // Dark background, no padding (shared styles, see Theme.h)
+  lv_obj_add_style(mainScreen, Theme::screen(), 0);
 
   // Configure flex layout for vertical arrangement
   // Similar to CSS flexbox with column direction
@@ -69,22 +82,31 @@ void MainInterface::init()
   // Create UI components in order (top to bottom)
   createHeader();
 
+  // Glyphs for both readings, pre-blended over the screen background
+  valueAtlas.build(&lv_font_montserrat_28, lv_color_hex(0xFFFFFF), lv_color_hex(0x000000));
+
   // Create temperature display directly on mainScreen
   tempLabel = lv_label_create(mainScreen);
-  lv_obj_set_style_text_font(tempLabel, &lv_font_montserrat_28, 0);
-  lv_obj_set_style_text_color(tempLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN);
-  lv_label_set_text(tempLabel, "Temperature:\n--.-°C");
-  lv_obj_align(tempLabel, LV_ALIGN_TOP_MID, 0, 50);
+  lv_obj_add_style(tempLabel, Theme::largeText(), 0);
+  lv_label_set_text(tempLabel, "Temperature:");
+  tempValue.create(mainScreen, valueAtlas, 8);
+  tempValue.setText("--.-°C");
 
   // Create humidity display directly on mainScreen
   humidityLabel = lv_label_create(mainScreen);
-  lv_obj_set_style_text_font(humidityLabel, &lv_font_montserrat_28, 0);
-  lv_obj_set_style_text_color(humidityLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN);
-  lv_label_set_text(humidityLabel, "Humidity:\n--.-%");
-  lv_obj_align_to(humidityLabel, tempLabel, LV_ALIGN_OUT_BOTTOM_MID, 0, 20);
-
-  // Activate the screen
-  lv_scr_load(mainScreen);
+  lv_obj_add_style(humidityLabel, Theme::largeText(), 0);
+  lv_label_set_text(humidityLabel, "Humidity:");
+  humidityValue.create(mainScreen, valueAtlas, 8);
+  humidityValue.setText("--.-%");
+
+  // Trend chart takes whatever height is left below the readings
+  trend.create(mainScreen);
+  lv_obj_set_width(trend.object(), lv_pct(100));
+  lv_obj_set_flex_grow(trend.object(), 1);
+  lv_obj_add_event_cb(trend.object(), onTrendClicked, LV_EVENT_CLICKED, this);
+
+  // ScreenManager loads it
+  return mainScreen;
 }
 
 /**
@@ -93,21 +115,28 @@ void MainInterface::init()
  */
 void MainInterface::createHeader()
 {
-  // Create header container with fixed height
+  // Create header container: full width, fixed height
   headerContainer = lv_obj_create(mainScreen);
-  lv_obj_set_size(headerContainer, 240, 40);
+  lv_obj_set_size(headerContainer, lv_pct(100), 40);
 
   // Style header with dark theme
-  lv_obj_set_style_bg_color(headerContainer, lv_color_hex(0x1E1E1E), LV_PART_MAIN);
-  lv_obj_set_style_pad_all(headerContainer, 5, 0);
+  lv_obj_add_style(headerContainer, Theme::header(), 0);
 
   // Create and configure header text
   headerLabel = lv_label_create(headerContainer);
   lv_label_set_text(headerLabel, "Temperature Monitor");
   // Center align the header text
   lv_obj_align(headerLabel, LV_ALIGN_CENTER, 0, 0);
-  // Set text color to white for contrast
-  lv_obj_set_style_text_color(headerLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN);
+  // White text for contrast
+  lv_obj_add_style(headerLabel, Theme::text(), 0);
+
+  // Tapping the header opens the event list
+  lv_obj_t *eventsIcon = lv_label_create(headerContainer);
+  lv_label_set_text(eventsIcon, LV_SYMBOL_BELL);
+  lv_obj_align(eventsIcon, LV_ALIGN_RIGHT_MID, 0, 0);
+  lv_obj_add_style(eventsIcon, Theme::text(), 0);
+  lv_obj_clear_flag(headerContainer, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_event_cb(headerContainer, onHeaderClicked, LV_EVENT_CLICKED, this);
 }
 
 /**
@@ -117,25 +146,86 @@ void MainInterface::createHeader()
  */
 
 /**
- * Update function called in main loop
- * Will be implemented later with sensor data
+ * Update function called once per frame from the main loop
+ * Applies the latest posted readings, one invalidation per value at most
  */
-
 void MainInterface::update()
 {
-  // Placeholder: update logic if needed
+  float values[UiUpdateQueue::MAX_SLOTS];
+  uint32_t changed = updates.take(values);
+  if (changed & (1u << SLOT_TEMPERATURE))
+    setTemperature(values[SLOT_TEMPERATURE]);
+  if (changed & (1u << SLOT_HUMIDITY))
+    setHumidity(values[SLOT_HUMIDITY]);
+  events.update();
+}
+
+void MainInterface::showHistory()
+{
+  if (historyLoader && screens.active() != historyId && screens.show(historyId))
+    history.show(*historyLoader);
+}
+
+lv_obj_t *MainInterface::buildMain(void *context)
+{
+  return static_cast<MainInterface *>(context)->createMainScreen();
+}
+
+void MainInterface::releaseMain(void *context)
+{
+  // Pinned, so only deleted from outside (e.g. the memory soak replacing it)
+  auto *self = static_cast<MainInterface *>(context);
+  self->mainScreen = self->headerContainer = self->headerLabel = nullptr;
+  self->tempLabel = self->humidityLabel = nullptr;
+}
+
+lv_obj_t *MainInterface::buildHistory(void *context)
+{
+  return static_cast<MainInterface *>(context)->history.build();
+}
+
+void MainInterface::releaseHistory(void *context)
+{
+  static_cast<MainInterface *>(context)->history.released();
+}
+
+lv_obj_t *MainInterface::buildEvents(void *context)
+{
+  return static_cast<MainInterface *>(context)->events.build();
+}
+
+void MainInterface::releaseEvents(void *context)
+{
+  static_cast<MainInterface *>(context)->events.released();
+}
+
+void MainInterface::showEvents()
+{
+  if (eventLog && screens.active() != eventsId && screens.show(eventsId))
+    events.show(*eventLog);
+}
+
+void MainInterface::onHeaderClicked(lv_event_t *e)
+{
+  static_cast<MainInterface *>(lv_event_get_user_data(e))->showEvents();
+}
+
+void MainInterface::onTrendClicked(lv_event_t *e)
+{
+  static_cast<MainInterface *>(lv_event_get_user_data(e))->showHistory();
 }
 
 void MainInterface::setTemperature(float tempC)
 {
+  // NaN is shown as "--.-°C"
   char buf[32];
-  snprintf(buf, sizeof(buf), "Temperature:\n%.1f°C", tempC);
-  lv_label_set_text(tempLabel, buf);
+  formatFixed(buf, sizeof(buf), tempC, 1, "°C");
+  tempValue.setText(buf);
 }
 
 void MainInterface::setHumidity(float humidity)
 {
   char buf[32];
-  snprintf(buf, sizeof(buf), "Humidity:\n%.1f%%", humidity);
-  lv_label_set_text(humidityLabel, buf);
+  formatFixed(buf, sizeof(buf), humidity, 1, "%");
+  humidityValue.setText(buf);
 }
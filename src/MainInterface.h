@@ -7,7 +7,8 @@
  * Description:
  * This header file defines the MainInterface class which manages a simple
  * scrollable interface with temperature display. Designed for portrait orientation
- * with a fixed header and scrollable content area.
+ * with a fixed header and scrollable content area; widths follow the display, so
+ * landscape works too.
  *
  * LVGL Layout Concepts:
  * - Flex Layout: Modern flexible box layout system
@@ -25,6 +26,12 @@
 
 #include <lvgl.h>
 #include <string>
+#include "DigitDisplay.h"
+#include "TrendChart.h"
+#include "HistoryScreen.h"
+#include "EventScreen.h"
+#include "ScreenManager.h"
+#include "UiUpdateQueue.h"
 
 using std::string;
 
@@ -41,19 +48,80 @@ private:
   lv_obj_t *tempLabel;
   lv_obj_t *humidityLabel;
 
+  // Readings are drawn from a pre-rasterised atlas; an update only redraws
+  // the digits that changed
+  DigitAtlas valueAtlas;
+  DigitDisplay tempValue;
+  DigitDisplay humidityValue;
+
+  // Recent history below the readings, one point per logged record
+  TrendChart trend;
+
+  // Screens are built on first visit and cached (see ScreenManager.h); the
+  // main screen is pinned
+  ScreenManager screens;
+  int8_t mainId;
+  int8_t historyId;
+  int8_t eventsId;
+
+  // Readings posted from other tasks, applied once per frame by update()
+  enum UpdateSlot : uint8_t
+  {
+    SLOT_TEMPERATURE,
+    SLOT_HUMIDITY
+  };
+  UiUpdateQueue updates;
+
+  // Opened by tapping the trend chart once a history source is set
+  HistoryScreen history;
+  HistoryLoader *historyLoader = nullptr;
+  static void onTrendClicked(lv_event_t *e);
+
+  // Opened by tapping the header once an event log is set
+  EventScreen events;
+  EventLog *eventLog = nullptr;
+  static void onHeaderClicked(lv_event_t *e);
+
   // Helper Methods
+  lv_obj_t *createMainScreen();
   void createHeader();
 
+  // ScreenManager hooks
+  static lv_obj_t *buildMain(void *context);
+  static void releaseMain(void *context);
+  static lv_obj_t *buildHistory(void *context);
+  static void releaseHistory(void *context);
+  static lv_obj_t *buildEvents(void *context);
+  static void releaseEvents(void *context);
+
 public:
   MainInterface();
   ~MainInterface();
 
   void init();
+  // Apply everything posted since the last call; schedule once per frame
   void update();
 
-  // Methods to update sensor values
+  // Methods to update sensor values (LVGL thread only, applied immediately)
   void setTemperature(float tempC);
   void setHumidity(float humidity);
+  // Same, from any task or core; the newest value is applied on the next update()
+  void postTemperature(float tempC) { updates.post(SLOT_TEMPERATURE, tempC); }
+  void postHumidity(float humidity) { updates.post(SLOT_HUMIDITY, humidity); }
+  const UiUpdateQueue &updateQueue() const { return updates; }
+
+  // Trend chart: append each logged record, backfill from storage at startup
+  TrendChart &trendChart() { return trend; }
+  // Stored readings for the history screen; nullptr disables it
+  void setHistoryLoader(HistoryLoader *loader) { historyLoader = loader; }
+  void showHistory();
+  // Alerts, faults and restarts for the event list; nullptr disables it
+  void setEventLog(EventLog *log) { eventLog = log; }
+  void showEvents();
+  EventScreen &eventScreen() { return events; }
+
+  // Screen cache, for its switch timing and memory report
+  ScreenManager &screenManager() { return screens; }
 };
 
 #endif // MAIN_INTERFACE_H
@@ -0,0 +1,13 @@
+#pragma once
+
+// Compile-time selection of the DisplayHAL backend (see DisplayHAL.h)
+#if defined(DISPLAY_BACKEND_LOVYANGFX)
+#include "LovyanDisplay.h"
+using PanelDisplay = LovyanDisplay;
+#elif defined(ARDUINO)
+#include "TftEspiDisplay.h"
+using PanelDisplay = TftEspiDisplay;
+#else
+#include "HostDisplay.h"
+using PanelDisplay = HostDisplay;
+#endif
@@ -0,0 +1,35 @@
+#include "PartitionFlash.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+PartitionFlash::PartitionFlash(const esp_partition_t *partition)
+    : part(partition)
+{
+}
+
+const esp_partition_t *PartitionFlash::findLogPartition()
+{
+  return esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, nullptr);
+}
+
+size_t PartitionFlash::size() const
+{
+  return part ? part->size : 0;
+}
+
+bool PartitionFlash::read(size_t offset, void *dst, size_t len)
+{
+  return part && esp_partition_read(part, offset, dst, len) == ESP_OK;
+}
+
+bool PartitionFlash::program(size_t offset, const void *src, size_t len)
+{
+  return part && esp_partition_write(part, offset, src, len) == ESP_OK;
+}
+
+bool PartitionFlash::eraseSector(size_t sector)
+{
+  return part && esp_partition_erase_range(part, sector * SPI_FLASH_SEC_SIZE, SPI_FLASH_SEC_SIZE) == ESP_OK;
+}
+
+#endif // ARDUINO_ARCH_ESP32
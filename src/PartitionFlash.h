@@ -0,0 +1,36 @@
+#pragma once
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include "FlashDevice.h"
+#include <esp_partition.h>
+
+/**
+ * FlashDevice backed by an ESP32 data partition.
+ *
+ * The build uses min_spiffs.csv and nothing mounts SPIFFS, so the spiffs data
+ * partition is reused as the raw ring-log area (see findLogPartition()).
+ */
+class PartitionFlash : public FlashDevice
+{
+public:
+  explicit PartitionFlash(const esp_partition_t *partition);
+
+  // Locate the spiffs data partition declared in min_spiffs.csv
+  static const esp_partition_t *findLogPartition();
+
+  const esp_partition_t *partition() const { return part; }
+
+  size_t size() const override;
+  size_t sectorSize() const override { return SPI_FLASH_SEC_SIZE; }
+  size_t pageSize() const override { return 256; }
+
+  bool read(size_t offset, void *dst, size_t len) override;
+  bool program(size_t offset, const void *src, size_t len) override;
+  bool eraseSector(size_t sector) override;
+
+private:
+  const esp_partition_t *part;
+};
+
+#endif // ARDUINO_ARCH_ESP32
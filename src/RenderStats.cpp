@@ -0,0 +1,99 @@
+#include "RenderStats.h"
+
+void Histogram::add(uint32_t value)
+{
+  uint8_t b = 0;
+  while (b + 1 < BUCKETS && (value >> (b + 1)) != 0)
+    b++;
+  counts[b]++;
+  n++;
+  sum += value;
+  if (value < lo)
+    lo = value;
+  if (value > hi)
+    hi = value;
+}
+
+void Histogram::reset()
+{
+  *this = Histogram();
+}
+
+uint32_t Histogram::percentile(uint8_t p) const
+{
+  if (n == 0)
+    return 0;
+  uint32_t target = (uint32_t)(((uint64_t)n * p + 99) / 100);
+  uint32_t seen = 0;
+  for (uint8_t b = 0; b < BUCKETS; b++)
+  {
+    seen += counts[b];
+    if (seen >= target && counts[b])
+    {
+      uint32_t upper = (b >= 31) ? UINT32_MAX : ((1u << (b + 1)) - 1);
+      return upper < hi ? upper : hi;
+    }
+  }
+  return hi;
+}
+
+void RenderStats::flushStarted(uint32_t px, uint32_t nowUs)
+{
+  flushStart = nowUs;
+  flushPixels = px;
+  flushActive = true;
+}
+
+void RenderStats::flushFinished(uint32_t nowUs)
+{
+  if (!flushActive)
+    return;
+  flushActive = false;
+  uint32_t us = nowUs - flushStart;
+  frameFlushUs += us;
+  framePixels += flushPixels;
+  totalFlushUs += us;
+  totalFlushBytes += (uint64_t)flushPixels * 2;
+}
+
+void RenderStats::refreshed(uint32_t invalidatedPx)
+{
+  frameRefreshed = true;
+  frameInvalidated += invalidatedPx;
+}
+
+void RenderStats::cycleFinished(uint32_t cycleUs)
+{
+  uint32_t blockedUs = frameBlockedUs;
+  frameBlockedUs = 0;
+  // The last stripe of a frame usually completes in a later (idle) cycle, so
+  // finished transfers accumulate until the next frame is recorded
+  if (!frameRefreshed)
+    return;
+
+  lastRender = cycleUs > blockedUs ? cycleUs - blockedUs : 0;
+  lastFlush = frameFlushUs;
+  lastPx = framePixels;
+  lastSaved = frameSkipped * 2;
+  render.add(lastRender);
+  flush.add(frameFlushUs);
+  pixels.add(framePixels);
+  area.add(frameInvalidated);
+  saved.add(lastSaved);
+
+  frameRefreshed = false;
+  frameInvalidated = 0;
+  frameFlushUs = 0;
+  framePixels = 0;
+  frameSkipped = 0;
+}
+
+void RenderStats::reset()
+{
+  *this = RenderStats();
+}
+
+uint32_t RenderStats::spiBytesPerSecond() const
+{
+  return totalFlushUs ? (uint32_t)(totalFlushBytes * 1000000ULL / totalFlushUs) : 0;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Log2-bucketed histogram: bucket i counts values in [2^i, 2^(i+1)).
+ * Cheap enough to update from the flush path on every frame.
+ */
+class Histogram
+{
+public:
+  static const uint8_t BUCKETS = 24;
+
+  void add(uint32_t value);
+  void reset();
+
+  uint32_t count() const { return n; }
+  uint32_t min() const { return n ? lo : 0; }
+  uint32_t max() const { return hi; }
+  uint32_t mean() const { return n ? (uint32_t)(sum / n) : 0; }
+  uint64_t total() const { return sum; }
+  // Upper bound of the bucket containing the p-th percentile (p in 0..100)
+  uint32_t percentile(uint8_t p) const;
+  uint32_t bucket(uint8_t i) const { return i < BUCKETS ? counts[i] : 0; }
+
+private:
+  uint32_t counts[BUCKETS] = {};
+  uint32_t n = 0;
+  uint32_t lo = UINT32_MAX;
+  uint32_t hi = 0;
+  uint64_t sum = 0;
+};
+
+/**
+ * Per-frame rendering instrumentation for TemplateCode.
+ *
+ * A frame is one lv_timer_handler() call that refreshed the display. For
+ * each frame it records:
+ * - render: CPU time in the handler minus time blocked waiting on transfers
+ * - flush: time from handing a stripe to the panel until the transfer finished
+ * - pixels whose transfer completed since the previous frame, and the
+ *   invalidated area LVGL reported
+ * - bytes the flush diff (FlushDiff) left out because the panel already had them
+ * and derives the effective SPI throughput from bytes flushed per flush time.
+ */
+class RenderStats
+{
+public:
+  // Called from the flush path
+  void flushStarted(uint32_t pixels, uint32_t nowUs);
+  void flushFinished(uint32_t nowUs);
+  void blocked(uint32_t us) { frameBlockedUs += us; }
+  void flushSkipped(uint32_t pixels) { frameSkipped += pixels; }
+  // Called from LVGL's monitor callback after a refresh
+  void refreshed(uint32_t invalidatedPx);
+  // Called after every lv_timer_handler(); records a frame if a refresh happened
+  void cycleFinished(uint32_t cycleUs);
+
+  void reset();
+
+  const Histogram &renderUs() const { return render; }
+  const Histogram &flushUs() const { return flush; }
+  const Histogram &pixelsFlushed() const { return pixels; }
+  const Histogram &invalidatedArea() const { return area; }
+  const Histogram &bytesSaved() const { return saved; }
+  uint32_t frames() const { return render.count(); }
+  // Effective SPI throughput over all frames (bytes of RGB565 per second)
+  uint32_t spiBytesPerSecond() const;
+
+  // Most recent frame, for the live overlay
+  uint32_t lastRenderUs() const { return lastRender; }
+  uint32_t lastFlushUs() const { return lastFlush; }
+  uint32_t lastPixels() const { return lastPx; }
+  uint32_t lastBytesSaved() const { return lastSaved; }
+
+private:
+  Histogram render;
+  Histogram flush;
+  Histogram pixels;
+  Histogram area;
+  Histogram saved;
+  uint64_t totalFlushUs = 0;
+  uint64_t totalFlushBytes = 0;
+
+  bool frameRefreshed = false;
+  uint32_t frameInvalidated = 0;
+  uint32_t frameBlockedUs = 0;
+  uint32_t frameFlushUs = 0;
+  uint32_t framePixels = 0;
+  uint32_t frameSkipped = 0;
+  uint32_t flushStart = 0;
+  uint32_t flushPixels = 0;
+  bool flushActive = false;
+
+  uint32_t lastRender = 0;
+  uint32_t lastFlush = 0;
+  uint32_t lastPx = 0;
+  uint32_t lastSaved = 0;
+};
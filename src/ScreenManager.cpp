@@ -0,0 +1,159 @@
+#include "ScreenManager.h"
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include "HostArduino.h"
+#endif
+#include "LvglMemory.h"
+
+namespace
+{
+  const uint32_t FRAME_US = LV_DISP_DEF_REFR_PERIOD * 1000UL;
+}
+
+ScreenManager::~ScreenManager()
+{
+  // Screens may outlive the manager; their delete events must not reach it
+  for (uint8_t i = 0; i < count; i++)
+    if (entries[i].obj)
+      lv_obj_remove_event_cb_with_user_data(entries[i].obj, onDeleted, &entries[i]);
+}
+
+int8_t ScreenManager::add(const Screen &screen)
+{
+  if (count >= MAX_SCREENS)
+    return -1;
+  Entry &e = entries[count];
+  e = {};
+  e.def = screen;
+  e.owner = this;
+  return (int8_t)count++;
+}
+
+uint8_t ScreenManager::builtCount() const
+{
+  uint8_t built = 0;
+  for (uint8_t i = 0; i < count; i++)
+    if (entries[i].obj)
+      built++;
+  return built;
+}
+
+bool ScreenManager::show(uint8_t id)
+{
+  if (id >= count)
+    return false;
+  Entry &e = entries[id];
+  uint32_t start = micros();
+  bool cold = !e.obj;
+  if (cold)
+  {
+    makeRoom(id);
+    uint32_t before = LvglMemory::stats().liveBytes;
+    e.obj = e.def.build(e.def.context);
+    if (!e.obj)
+      return false;
+    uint32_t after = LvglMemory::stats().liveBytes;
+    e.bytes = after > before ? after - before : 0;
+    e.builds++;
+    lv_obj_add_event_cb(e.obj, onDeleted, LV_EVENT_DELETE, &e);
+  }
+  if (lv_scr_act() != e.obj)
+  {
+    lv_scr_load(e.obj);
+    // Finished by frameFlushed(); a newer show() replaces an unfinished one
+    timing = (int8_t)id;
+    timingCold = cold;
+    timingStart = start;
+  }
+  if (current >= 0 && current != (int8_t)id)
+    previous = current;
+  current = (int8_t)id;
+  e.lastShown = ++sequence;
+  e.visits++;
+  return true;
+}
+
+void ScreenManager::frameFlushed()
+{
+  if (timing < 0)
+    return;
+  Entry &e = entries[timing];
+  timing = -1;
+  // The screen was deleted before it was ever drawn
+  if (!e.obj)
+    return;
+  uint32_t us = micros() - timingStart;
+  if (timingCold)
+  {
+    e.buildUs = us;
+    return;
+  }
+  e.cachedUs = us;
+  if (us > e.maxCachedUs)
+    e.maxCachedUs = us;
+  if (us > FRAME_US)
+    e.slowCached++;
+}
+
+bool ScreenManager::back()
+{
+  return previous >= 0 && show((uint8_t)previous);
+}
+
+bool ScreenManager::evict(uint8_t id)
+{
+  if (id >= count || !entries[id].obj || (int8_t)id == current)
+    return false;
+  // onDeleted clears the entry and releases the owner's pointers
+  lv_obj_del(entries[id].obj);
+  evictions++;
+  return true;
+}
+
+void ScreenManager::makeRoom(uint8_t keep)
+{
+  while (builtCount() >= SCREEN_CACHE_SIZE)
+  {
+    int8_t victim = -1;
+    for (uint8_t i = 0; i < count; i++)
+    {
+      const Entry &e = entries[i];
+      if (!e.obj || e.def.pinned || i == keep || (int8_t)i == current)
+        continue;
+      if (victim < 0 || e.lastShown < entries[victim].lastShown)
+        victim = (int8_t)i;
+    }
+    // Everything left is pinned or in use: go over rather than fail
+    if (victim < 0 || !evict((uint8_t)victim))
+      return;
+  }
+}
+
+void ScreenManager::onDeleted(lv_event_t *e)
+{
+  auto *entry = static_cast<Entry *>(lv_event_get_user_data(e));
+  ScreenManager *self = entry->owner;
+  entry->obj = nullptr;
+  int8_t id = (int8_t)(entry - self->entries);
+  if (self->current == id)
+    self->current = -1;
+  if (self->previous == id)
+    self->previous = -1;
+  if (entry->def.released)
+    entry->def.released(entry->def.context);
+}
+
+void ScreenManager::printReport(Print &out) const
+{
+  out.printf("Screens: %u/%u built, %lu evictions, frame %lu us\n", (unsigned)builtCount(),
+             (unsigned)SCREEN_CACHE_SIZE, (unsigned long)evictions, (unsigned long)FRAME_US);
+  for (uint8_t i = 0; i < count; i++)
+  {
+    const Entry &e = entries[i];
+    out.printf("  %-10s %c%c visits %5lu builds %4lu %6lu B  build %6lu us  cached %5lu us (max %lu, %lu over a frame)\n",
+               e.def.name, e.obj ? '*' : ' ', e.def.pinned ? 'P' : ' ', (unsigned long)e.visits,
+               (unsigned long)e.builds, (unsigned long)e.bytes, (unsigned long)e.buildUs,
+               (unsigned long)e.cachedUs, (unsigned long)e.maxCachedUs, (unsigned long)e.slowCached);
+  }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdint.h>
+#include <lvgl.h>
+
+class Print;
+
+// Screens kept built at once, the active one included. Beyond that the least
+// recently shown unpinned screen is deleted. At least 2, so the screen being
+// left (whose event may be running) is never the one evicted. The default is
+// below the firmware's three screens: the pinned main screen plus the one
+// side screen last shown stay built, the other is rebuilt when needed.
+#ifndef SCREEN_CACHE_SIZE
+#define SCREEN_CACHE_SIZE 2
+#endif
+#if SCREEN_CACHE_SIZE < 2
+#error "SCREEN_CACHE_SIZE must be at least 2"
+#endif
+
+/**
+ * Lazily built screens with a small LRU cache.
+ *
+ * Screens are registered up front but only built on their first show().
+ * Switching to a screen that is still built is just lv_scr_load(); one that
+ * was evicted is built again. Every screen's widgets live in the LVGL pool,
+ * so the cache size, not the number of screens, bounds UI memory. Eviction
+ * runs before the new screen is built, so the peak stays at the cache size.
+ *
+ * released() is called whenever a screen is deleted, by eviction or by
+ * anyone else (seen through LV_EVENT_DELETE), so owners can drop their
+ * pointers into the widget tree and rebuild cleanly next time.
+ *
+ * Every build records the LVGL memory it took. A switch is timed from
+ * show() until the first refresh of the new screen is on the panel, which
+ * the display reports through frameFlushed() (pass frameListener to
+ * TemplateCode::setFrameListener()). Without that hook switches are not
+ * timed. A switch to a cached screen should fit in one frame
+ * (LV_DISP_DEF_REFR_PERIOD); printReport() counts those that did not.
+ */
+class ScreenManager
+{
+public:
+  static const uint8_t MAX_SCREENS = 8;
+
+  struct Screen
+  {
+    const char *name;
+    // Create the screen with lv_obj_create(NULL) and its widgets; nullptr on failure
+    lv_obj_t *(*build)(void *context);
+    // The screen has been deleted; may be nullptr
+    void (*released)(void *context);
+    void *context;
+    bool pinned; // counts towards the cache but is never evicted
+  };
+
+  ScreenManager() = default;
+  ~ScreenManager();
+  ScreenManager(const ScreenManager &) = delete;
+  ScreenManager &operator=(const ScreenManager &) = delete;
+
+  // Returns the screen's id, or -1 once MAX_SCREENS are registered
+  int8_t add(const Screen &screen);
+  // Build the screen if needed and load it; false for a bad id or a failed build
+  bool show(uint8_t id);
+  // Show the screen that was active before the current one
+  bool back();
+  // Delete a built screen now; the active one is never evicted
+  bool evict(uint8_t id);
+
+  // A refresh has been flushed to the panel: ends the timing of the last show()
+  void frameFlushed();
+  // Adapter for TemplateCode::setFrameListener(), context is the ScreenManager
+  static void frameListener(void *manager) { static_cast<ScreenManager *>(manager)->frameFlushed(); }
+
+  bool isBuilt(uint8_t id) const { return id < count && entries[id].obj; }
+  // Id of the screen on display, -1 if none (or it was deleted elsewhere)
+  int8_t active() const { return current; }
+  uint8_t builtCount() const;
+
+  // Per screen: visits, builds, memory, build and cached switch times
+  void printReport(Print &out) const;
+
+private:
+  struct Entry
+  {
+    Screen def;
+    ScreenManager *owner;
+    lv_obj_t *obj;
+    uint32_t lastShown; // sequence number, for LRU
+    uint32_t visits;
+    uint32_t builds;
+    uint32_t bytes;       // LVGL memory taken by the last build
+    uint32_t buildUs;     // last switch that had to build
+    uint32_t cachedUs;    // last switch to the built screen
+    uint32_t maxCachedUs;
+    uint32_t slowCached; // cached switches longer than a frame
+  };
+
+  // Evict until a screen other than keep can be built within the cache size
+  void makeRoom(uint8_t keep);
+  static void onDeleted(lv_event_t *e);
+
+  Entry entries[MAX_SCREENS] = {};
+  uint8_t count = 0;
+  int8_t current = -1;
+  int8_t previous = -1;
+  // Switch waiting for its first flushed frame, -1 if none
+  int8_t timing = -1;
+  bool timingCold = false;
+  uint32_t timingStart = 0;
+  uint32_t sequence = 0;
+  uint32_t evictions = 0;
+};
@@ -0,0 +1,105 @@
+#include "SimulatedFlash.h"
+
+#if !defined(ARDUINO)
+
+#include <stdio.h>
+#include <string.h>
+
+SimulatedFlash::SimulatedFlash(size_t size, size_t sectorSize, size_t pageSize)
+    : sector(sectorSize), page(pageSize), mem(size, 0xFF), erases(size / sectorSize, 0), programs(0), violations(0)
+{
+}
+
+bool SimulatedFlash::loadImage(const char *path)
+{
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  size_t n = fread(mem.data(), 1, mem.size(), f);
+  fclose(f);
+  return n == mem.size();
+}
+
+bool SimulatedFlash::saveImage(const char *path) const
+{
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  size_t n = fwrite(mem.data(), 1, mem.size(), f);
+  fclose(f);
+  return n == mem.size();
+}
+
+bool SimulatedFlash::read(size_t offset, void *dst, size_t len)
+{
+  if (offset + len > mem.size())
+    return false;
+  memcpy(dst, &mem[offset], len);
+  return true;
+}
+
+bool SimulatedFlash::program(size_t offset, const void *src, size_t len)
+{
+  if (len == 0)
+    return true;
+  if (offset + len > mem.size())
+    return false;
+  // A single program operation cannot cross a page boundary
+  if (offset / page != (offset + len - 1) / page)
+  {
+    violations++;
+    return false;
+  }
+
+  const uint8_t *in = (const uint8_t *)src;
+  for (size_t i = 0; i < len; i++)
+  {
+    // NOR can only clear bits; anything needing 0 -> 1 requires an erase first
+    if ((mem[offset + i] & in[i]) != in[i])
+    {
+      violations++;
+      return false;
+    }
+  }
+  for (size_t i = 0; i < len; i++)
+    mem[offset + i] &= in[i];
+  programs++;
+  return true;
+}
+
+bool SimulatedFlash::eraseSector(size_t index)
+{
+  if (index >= erases.size())
+    return false;
+  memset(&mem[index * sector], 0xFF, sector);
+  erases[index]++;
+  return true;
+}
+
+uint32_t SimulatedFlash::minEraseCount() const
+{
+  uint32_t m = UINT32_MAX;
+  for (uint32_t e : erases)
+    if (e < m)
+      m = e;
+  return erases.empty() ? 0 : m;
+}
+
+uint32_t SimulatedFlash::maxEraseCount() const
+{
+  uint32_t m = 0;
+  for (uint32_t e : erases)
+    if (e > m)
+      m = e;
+  return m;
+}
+
+uint32_t SimulatedFlash::totalErases() const
+{
+  uint32_t total = 0;
+  for (uint32_t e : erases)
+    total += e;
+  return total;
+}
+
+#endif // !ARDUINO
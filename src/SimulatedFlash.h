@@ -0,0 +1,52 @@
+#pragma once
+
+#if !defined(ARDUINO)
+
+#include "FlashDevice.h"
+#include <vector>
+
+/**
+ * Host-side NOR flash simulator for exercising FlashRingLog on Linux.
+ *
+ * Enforces the same rules as the real chip: erase sets a whole sector to
+ * 0xFF, program can only clear bits and must stay inside one page. Attempts
+ * to set a bit back to 1 without an erase are rejected and counted so wear
+ * levelling and batching bugs show up in host runs instead of on hardware.
+ */
+class SimulatedFlash : public FlashDevice
+{
+public:
+  SimulatedFlash(size_t size, size_t sectorSize = 4096, size_t pageSize = 256);
+
+  // Image files let a host run persist flash contents across "reboots"
+  bool loadImage(const char *path);
+  bool saveImage(const char *path) const;
+
+  size_t size() const override { return mem.size(); }
+  size_t sectorSize() const override { return sector; }
+  size_t pageSize() const override { return page; }
+
+  bool read(size_t offset, void *dst, size_t len) override;
+  bool program(size_t offset, const void *src, size_t len) override;
+  bool eraseSector(size_t index) override;
+
+  // Wear and traffic statistics
+  uint32_t eraseCount(size_t index) const { return index < erases.size() ? erases[index] : 0; }
+  uint32_t minEraseCount() const;
+  uint32_t maxEraseCount() const;
+  uint32_t totalErases() const;
+  uint32_t programCount() const { return programs; }
+  uint32_t violationCount() const { return violations; }
+
+  const uint8_t *data() const { return mem.data(); }
+
+private:
+  size_t sector;
+  size_t page;
+  std::vector<uint8_t> mem;
+  std::vector<uint32_t> erases;
+  uint32_t programs;
+  uint32_t violations;
+};
+
+#endif // !ARDUINO
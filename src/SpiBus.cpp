@@ -0,0 +1,38 @@
+#include "SpiBus.h"
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif
+
+namespace
+{
+  void (*drainHook)() = nullptr;
+#if defined(ARDUINO_ARCH_ESP32)
+  // Created on first use, which is during setup() before any other task runs
+  SemaphoreHandle_t mutex = nullptr;
+#endif
+}
+
+void SpiBus::lock()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  if (!mutex)
+    mutex = xSemaphoreCreateRecursiveMutex();
+  xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+#endif
+  // A transfer can only still be running if this task started it
+  if (drainHook)
+    drainHook();
+}
+
+void SpiBus::unlock()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  xSemaphoreGiveRecursive(mutex);
+#endif
+}
+
+void SpiBus::setDrain(void (*drain)())
+{
+  drainHook = drain;
+}
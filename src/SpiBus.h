@@ -0,0 +1,50 @@
+#pragma once
+
+/**
+ * Arbitration for the VSPI bus, shared by the panel, the XPT2046 resistive
+ * touch controller and the SD card.
+ *
+ * The panel's DMA flush returns while the transfer is still running, so
+ * a plain "wait for the transfer" before each touch read is not enough once
+ * SD access runs on other tasks (the scheduler's logging and commits, the
+ * HistoryLoader on core 0). Every user takes this lock around its bus
+ * traffic instead:
+ * - TemplateCode takes it when it starts a flush and releases it when the
+ *   transfer has completed, so nothing else can drive the bus meanwhile
+ * - touch reads and FileManager's SD access hold a Guard for their duration
+ *
+ * The lock is recursive. Only the task that started a transfer can hold the
+ * lock while it runs, so lock() finishes an in-flight transfer through the
+ * drain hook (TemplateCode's completeFlush) before returning; other tasks
+ * simply wait until the flush releases it.
+ *
+ * Host builds have a single thread and no real bus: only the drain runs.
+ */
+namespace SpiBus
+{
+  void lock();
+  void unlock();
+  // Called by lock() to finish a transfer the calling task still has running
+  void setDrain(void (*drain)());
+
+  // Holds the bus for a scope; engage = false makes it a no-op (e.g. flash-only paths)
+  class Guard
+  {
+  public:
+    explicit Guard(bool engage = true) : held(engage)
+    {
+      if (held)
+        lock();
+    }
+    ~Guard()
+    {
+      if (held)
+        unlock();
+    }
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+
+  private:
+    bool held;
+  };
+}
@@ -0,0 +1,95 @@
+#include "StyleCheck.h"
+#include "LvglMemory.h"
+#include "Theme.h"
+
+namespace
+{
+  const uint32_t LOOKUP_ROUNDS = 200;
+}
+
+void StyleCheck::run(TemplateCode &display, uint16_t rows)
+{
+  Theme::init();
+  lv_obj_t *prevScreen = lv_scr_act();
+
+  Serial.printf("Style check: %u rows (container + label each)\n", (unsigned)rows);
+  for (int shared = 0; shared <= 1; shared++)
+  {
+    uint32_t before = LvglMemory::stats().liveBytes;
+    lv_obj_t *screen = createScreen(shared, rows);
+    uint32_t bytes = LvglMemory::stats().liveBytes - before;
+
+    uint32_t lookups = 0;
+    uint32_t lookupUs = timeLookups(screen, LOOKUP_ROUNDS, &lookups);
+    lv_scr_load(screen);
+    uint32_t redrawUs = display.measureFullRedraw();
+
+    Serial.printf("%-7s styles: %6lu B (%lu B/widget), lookup %lu ns, full redraw %lu us\n",
+                  shared ? "shared" : "local", (unsigned long)bytes, (unsigned long)(bytes / (rows * 2u)),
+                  (unsigned long)(lookups ? (uint64_t)lookupUs * 1000 / lookups : 0), (unsigned long)redrawUs);
+
+    lv_scr_load(prevScreen);
+    lv_obj_del(screen);
+  }
+}
+
+lv_obj_t *StyleCheck::createScreen(bool shared, uint16_t rows)
+{
+  lv_obj_t *screen = lv_obj_create(NULL);
+  if (shared)
+    lv_obj_add_style(screen, Theme::screen(), 0);
+  else
+  {
+    lv_obj_set_style_bg_color(screen, lv_color_hex(0x000000), LV_PART_MAIN);
+    lv_obj_set_style_pad_all(screen, 0, 0);
+  }
+  lv_obj_set_layout(screen, LV_LAYOUT_FLEX);
+  lv_obj_set_flex_flow(screen, LV_FLEX_FLOW_COLUMN);
+
+  for (uint16_t i = 0; i < rows; i++)
+  {
+    lv_obj_t *row = lv_obj_create(screen);
+    lv_obj_set_size(row, lv_pct(100), 40);
+    lv_obj_t *label = lv_label_create(row);
+    lv_label_set_text(label, "Temperature:");
+    if (shared)
+    {
+      lv_obj_add_style(row, Theme::header(), 0);
+      lv_obj_add_style(label, Theme::largeText(), 0);
+    }
+    else
+    {
+      lv_obj_set_style_bg_color(row, lv_color_hex(0x1E1E1E), LV_PART_MAIN);
+      lv_obj_set_style_pad_all(row, 5, 0);
+      lv_obj_set_style_text_font(label, &lv_font_montserrat_28, 0);
+      lv_obj_set_style_text_color(label, lv_color_hex(0xFFFFFF), LV_PART_MAIN);
+    }
+  }
+  return screen;
+}
+
+uint32_t StyleCheck::timeLookups(lv_obj_t *screen, uint32_t rounds, uint32_t *lookups)
+{
+  // Properties the renderer reads for a container and a label; border_width is
+  // not set by either variant, so its lookup walks every style to the theme
+  volatile uint32_t sink = 0;
+  uint32_t count = lv_obj_get_child_cnt(screen);
+  uint32_t start = micros();
+  for (uint32_t r = 0; r < rounds; r++)
+  {
+    for (uint32_t i = 0; i < count; i++)
+    {
+      lv_obj_t *row = lv_obj_get_child(screen, i);
+      lv_obj_t *label = lv_obj_get_child(row, 0);
+      sink = sink + lv_obj_get_style_bg_color(row, LV_PART_MAIN).full;
+      sink = sink + lv_obj_get_style_pad_top(row, LV_PART_MAIN);
+      sink = sink + lv_obj_get_style_border_width(row, LV_PART_MAIN);
+      sink = sink + lv_obj_get_style_text_color(label, LV_PART_MAIN).full;
+      sink = sink + (uintptr_t)lv_obj_get_style_text_font(label, LV_PART_MAIN);
+      sink = sink + lv_obj_get_style_border_width(label, LV_PART_MAIN);
+    }
+  }
+  uint32_t us = micros() - start;
+  *lookups = rounds * count * 6;
+  return us;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <lvgl.h>
+#include "TemplateCode.h"
+
+/**
+ * Local versus shared styles, measured.
+ *
+ * Builds the same screen twice: rows of a header-style container and a
+ * caption label, once styled with lv_obj_set_style_*() as MainInterface
+ * used to be, once with Theme's shared styles. For each it reports the LVGL
+ * memory the screen took, the time to resolve style properties (set and
+ * unset ones, as the renderer does on every draw) and a full redraw.
+ *
+ * Enable with -DRUN_STYLE_CHECK in platformio.ini, or run
+ * `program --style-check` on the host build.
+ */
+class StyleCheck
+{
+public:
+  static void run(TemplateCode &display, uint16_t rows = 16);
+
+private:
+  static lv_obj_t *createScreen(bool shared, uint16_t rows);
+  static uint32_t timeLookups(lv_obj_t *screen, uint32_t rounds, uint32_t *lookups);
+};
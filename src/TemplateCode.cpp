@@ -5,22 +5,31 @@
  */
 
 #include "TemplateCode.h"
+#include <string.h>
+#include "SpiBus.h"
 
 // Initialize static members
 TemplateCode *TemplateCode::instance = nullptr;
+#if defined(MODEL_JC2432W328C)
+volatile bool TemplateCode::touchIrq = false;
+#endif
 lv_disp_draw_buf_t TemplateCode::draw_buf;
-lv_color_t TemplateCode::buf[SCREEN_WIDTH * SCREEN_HEIGHT / 10];
+lv_disp_drv_t TemplateCode::disp_drv;
+lv_indev_drv_t TemplateCode::indev_drv;
+#if LV_COLOR_DEPTH == 8
+uint16_t TemplateCode::palette[256];
+#endif
 
 TemplateCode::TemplateCode()
 #if defined(MODEL_JC2432W328R)
     : mySpi(VSPI),
       ts(XPT2046_CS, XPT2046_IRQ),
-      tft(SCREEN_WIDTH, SCREEN_HEIGHT)
+      panel(PANEL_WIDTH, PANEL_HEIGHT)
 #elif defined(MODEL_JC2432W328C)
     : ts(),
-      tft(SCREEN_WIDTH, SCREEN_HEIGHT)
+      panel(PANEL_WIDTH, PANEL_HEIGHT)
 #else
-    : tft(SCREEN_WIDTH, SCREEN_HEIGHT)
+    : panel(PANEL_WIDTH, PANEL_HEIGHT)
 #endif
 {
 }
@@ -40,6 +49,9 @@ bool TemplateCode::begin()
   lv_log_register_print_cb(debugPrint);
 #endif
 
+  // Other bus users wait on the lock; a transfer of our own is finished first
+  SpiBus::setDrain([]
+                   { getInstance().completeFlush(true); });
   initializeHardware();
   initializeLVGL();
   setupTouchscreen();
@@ -50,8 +62,10 @@ bool TemplateCode::begin()
 
 void TemplateCode::initializeHardware()
 {
+#ifdef ARDUINO
   initRGBled();
   ChangeRGBColor(RGB_COLOR_1);
+#endif
 
 #if defined(MODEL_JC2432W328R)
   mySpi.begin(XPT2046_CLK, XPT2046_MISO, XPT2046_MOSI, XPT2046_CS);
@@ -61,22 +75,155 @@ void TemplateCode::initializeHardware()
 void TemplateCode::initializeLVGL()
 {
   lv_init();
-  lv_disp_draw_buf_init(&draw_buf, buf, nullptr, SCREEN_WIDTH * SCREEN_HEIGHT / 10);
+#if LV_COLOR_DEPTH == 8
+  // Allocated first: without them nothing can reach the panel
+  allocateExpandBuffers(LVGL_EXPAND_LINES);
+#endif
+  setDrawBuffers(LVGL_DRAW_BUF_LINES, LVGL_DRAW_BUF_COUNT);
+}
+
+#if LV_COLOR_DEPTH == 8
+bool TemplateCode::allocateExpandBuffers(uint16_t lines)
+{
+  // Widen each RGB332 channel by bit replication (full scale maps to full
+  // scale) and store in panel byte order
+  for (uint16_t i = 0; i < 256; i++)
+  {
+    lv_color_t c;
+    c.full = (uint8_t)i;
+    uint16_t r = c.ch.red, g = c.ch.green, b = c.ch.blue;
+    uint16_t rgb565 = (uint16_t)((r << 2 | r >> 1) << 11 | (g << 3 | g) << 5 | (b << 3 | b << 1 | b >> 1));
+    palette[i] = (uint16_t)(rgb565 << 8 | rgb565 >> 8);
+  }
+
+  for (; lines > 0; lines /= 2)
+  {
+    size_t bytes = (size_t)MAX_LINE * lines * sizeof(uint16_t);
+    expandBuf[0] = (uint16_t *)heap_caps_malloc(bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    expandBuf[1] = (uint16_t *)heap_caps_malloc(bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (expandBuf[0] && expandBuf[1])
+    {
+      expandPixels = (uint32_t)MAX_LINE * lines;
+      return true;
+    }
+    heap_caps_free(expandBuf[0]);
+    heap_caps_free(expandBuf[1]);
+    expandBuf[0] = expandBuf[1] = nullptr;
+  }
+  Serial.println("TemplateCode: no DMA-capable RAM for 8-bit expansion buffers");
+  return false;
+}
+
+uint32_t TemplateCode::pushExpanded(int32_t x, int32_t y, uint32_t w, uint32_t h, const lv_color_t *pixels)
+{
+  if (!expandPixels)
+    return 0;
+  // Chunks are whole rows of the stripe, as many as fit in one expansion buffer
+  uint32_t chunkRows = expandPixels / w;
+  uint32_t sent = 0;
+  uint8_t next = 0;
+  for (uint32_t row = 0; row < h; row += chunkRows, next ^= 1)
+  {
+    uint32_t rows = h - row < chunkRows ? h - row : chunkRows;
+    uint32_t count = w * rows;
+    const lv_color_t *src = pixels + (size_t)row * w;
+    // Every push waits for the one before it, so only the buffer of the last
+    // push can still be in flight. With the flush diff a chunk may push
+    // nothing, and that can be the buffer about to be refilled.
+    if (expandBusy == next)
+    {
+      panel.waitTransfer();
+      expandBusy = -1;
+    }
+    uint16_t *dst = expandBuf[next];
+    for (uint32_t i = 0; i < count; i++)
+      dst[i] = palette[src[i].full];
+    uint32_t pushed = pushStripe(x, y + row, w, rows, dst);
+    if (pushed)
+      expandBusy = next;
+    sent += pushed;
+  }
+  return sent;
+}
+#endif
+
+size_t TemplateCode::expandBufferBytes() const
+{
+#if LV_COLOR_DEPTH == 8
+  return (size_t)expandPixels * sizeof(uint16_t) * 2;
+#else
+  return 0;
+#endif
+}
+
+bool TemplateCode::setDrawBuffers(uint16_t lines, uint8_t count)
+{
+  // Never free a buffer that is still being clocked out
+  completeFlush(true);
+  heap_caps_free(buf);
+  heap_caps_free(buf2);
+  buf = buf2 = nullptr;
+  bufPixels = 0;
+
+  if (lines > screenH)
+    lines = screenH;
+#if !LVGL_DMA_FLUSH
+  count = 1; // A second buffer gives no overlap with blocking transfers
+#endif
+
+  // Halve the stripe until it fits in DMA-capable internal RAM. At least one
+  // line in every orientation, so a later setRotation() never needs more.
+  uint32_t pixels = 0;
+  for (; lines > 0; lines /= 2)
+  {
+    pixels = (uint32_t)screenW * lines;
+    if (pixels < MAX_LINE)
+      pixels = MAX_LINE;
+    size_t bytes = (size_t)pixels * sizeof(lv_color_t);
+    buf = (lv_color_t *)heap_caps_malloc(bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (buf && count > 1)
+      buf2 = (lv_color_t *)heap_caps_malloc(bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (buf && (count < 2 || buf2))
+      break;
+    heap_caps_free(buf);
+    buf = nullptr;
+  }
+  if (!buf)
+  {
+    Serial.println("TemplateCode: no DMA-capable RAM for LVGL draw buffer");
+    return false;
+  }
+
+  bufPixels = pixels;
+  lv_disp_draw_buf_init(&draw_buf, buf, buf2, pixels);
+  return true;
 }
 
 void TemplateCode::setupTouchscreen()
 {
 #if defined(MODEL_JC2432W328R)
   ts.begin(mySpi);
-  ts.setRotation(TFT_ROTATION);
 #endif
 #if defined(MODEL_JC2432W328C)
   // Initialize BitBank capacitive touch with I2C pins + reset/irq
   ts.init(CST820_SDA, CST820_SCL, CST820_RST, CST820_INT);
+  // INT pulses low with every report while the panel is touched; latch it so
+  // the adaptive refresh can wake on a touch without polling over I2C
+  attachInterrupt(digitalPinToInterrupt(CST820_INT), onTouchIrq, FALLING);
+#endif
+  applyTouchRotation();
+}
 
-  // Map TFT_ROTATION (0..3) to degrees for setOrientation
+void TemplateCode::applyTouchRotation()
+{
+#if defined(MODEL_JC2432W328R)
+  // readTouchpad() maps the rotated raw coordinates onto screenW x screenH
+  ts.setRotation(rotation);
+#endif
+#if defined(MODEL_JC2432W328C)
+  // Map rotation (0..3) to degrees for setOrientation
   int oriDeg = 0;
-  switch (TFT_ROTATION & 0x3)
+  switch (rotation)
   {
   case 0:
     oriDeg = 0;
@@ -91,50 +238,209 @@ void TemplateCode::setupTouchscreen()
     oriDeg = 270;
     break;
   }
-  ts.setOrientation(oriDeg, SCREEN_WIDTH, SCREEN_HEIGHT);
-  Serial.printf("BBCapTouch init: sensor=%d orient=%d %ux%u\n", ts.sensorType(), oriDeg, (unsigned)SCREEN_WIDTH, (unsigned)SCREEN_HEIGHT);
+  ts.setOrientation(oriDeg, screenW, screenH);
+  Serial.printf("BBCapTouch init: sensor=%d orient=%d %ux%u\n", ts.sensorType(), oriDeg, (unsigned)screenW, (unsigned)screenH);
   Serial.flush();
 #endif
 }
 
 void TemplateCode::setupDisplay()
 {
-  tft.begin();
-  tft.setRotation(TFT_ROTATION);
+  // Single panel initialisation for the whole firmware
+  panel.begin(rotation, SWAP_ON_FLUSH);
 
-  static lv_disp_drv_t disp_drv;
   lv_disp_drv_init(&disp_drv);
-  disp_drv.hor_res = SCREEN_WIDTH;
-  disp_drv.ver_res = SCREEN_HEIGHT;
+  disp_drv.hor_res = screenW;
+  disp_drv.ver_res = screenH;
   disp_drv.flush_cb = flushDisplay;
+  // Called by LVGL while it waits for a buffer to be released
+  disp_drv.wait_cb = waitFlush;
+  // Reports the invalidated area after every refresh
+  disp_drv.monitor_cb = monitorRefresh;
   disp_drv.draw_buf = &draw_buf;
-  lv_disp_drv_register(&disp_drv);
+#if LVGL_FLUSH_DIFF
+  if (flushDiff.begin(screenW, screenH, LVGL_FLUSH_DIFF_TILE))
+    disp_drv.rounder_cb = roundFlushArea;
+  else
+    Serial.println("TemplateCode: no RAM for flush diff, flushing every pixel");
+#endif
+  disp = lv_disp_drv_register(&disp_drv);
 
-  static lv_indev_drv_t indev_drv;
   lv_indev_drv_init(&indev_drv);
   indev_drv.type = LV_INDEV_TYPE_POINTER;
   indev_drv.read_cb = readTouchpad;
   lv_indev_drv_register(&indev_drv);
 }
 
+void TemplateCode::setRotation(uint8_t value)
+{
+  value &= 3;
+  if (value == rotation)
+    return;
+  // The panel must not change orientation under a running transfer
+  SpiBus::Guard bus;
+  rotation = value;
+  bool quarter = (rotation & 1) != 0;
+  screenW = quarter ? PANEL_HEIGHT : PANEL_WIDTH;
+  screenH = quarter ? PANEL_WIDTH : PANEL_HEIGHT;
+
+  // Sends MADCTL only; the controller keeps its other settings
+  panel.setRotation(rotation);
+  applyTouchRotation();
+  // The hashes describe the old orientation
+  if (flushDiff.active())
+    flushDiff.begin(screenW, screenH, flushDiff.tileSize());
+
+  // Resizes every screen, marks all layouts dirty and invalidates the active
+  // screen, so the next refresh redraws it at the new size
+  disp_drv.hor_res = screenW;
+  disp_drv.ver_res = screenH;
+  lv_disp_drv_update(disp, &disp_drv);
+  resizeLayers();
+}
+
+void TemplateCode::resizeLayers()
+{
+  lv_obj_t *layers[] = {lv_disp_get_layer_top(disp), lv_disp_get_layer_sys(disp)};
+  for (lv_obj_t *layer : layers)
+  {
+    lv_area_t previous;
+    lv_obj_get_coords(layer, &previous);
+    lv_area_set_width(&layer->coords, screenW);
+    lv_area_set_height(&layer->coords, screenH);
+    // Marks the children's layout dirty, so aligned objects (the stats overlay) move
+    lv_event_send(layer, LV_EVENT_SIZE_CHANGED, &previous);
+  }
+}
+
 void TemplateCode::flushDisplay(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
 {
   auto &display = getInstance();
   uint32_t w = (area->x2 - area->x1 + 1);
   uint32_t h = (area->y2 - area->y1 + 1);
 
-  display.tft.startWrite();
-  display.tft.setAddrWindow(area->x1, area->y1, w, h);
-  display.tft.pushColors((uint16_t *)&color_p->full, w * h, true);
-  display.tft.endWrite();
+  // Start the transfer and return; with DMA backends LVGL renders the next
+  // stripe into the other buffer meanwhile. lv_disp_flush_ready() is issued
+  // by completeFlush() once the transfer has finished. The bus stays locked
+  // until then, so SD and touch cannot drive it under the DMA.
+  SpiBus::lock();
+  uint32_t start = micros();
+#if LV_COLOR_DEPTH == 8
+  uint32_t sent = display.pushExpanded(area->x1, area->y1, w, h, color_p);
+  // Expansion and waits on earlier chunks are flush cost, not render cost
+  display.stats.blocked(micros() - start);
+#else
+  uint32_t sent = display.pushStripe(area->x1, area->y1, w, h, (uint16_t *)&color_p->full);
+#endif
+  display.stats.flushSkipped(w * h - sent);
+  display.stats.flushStarted(sent, start);
+  display.pendingFlush = disp_drv;
+  display.completeFlush(false);
+}
 
-  lv_disp_flush_ready(disp_drv);
+uint32_t TemplateCode::pushStripe(int32_t x, int32_t y, uint32_t w, uint32_t h, uint16_t *pixels)
+{
+  // The flush diff may split the stripe into several smaller windows, or send nothing
+  if (flushDiff.active())
+    return flushDiff.push(panel, x, y, w, h, pixels);
+  panel.pushPixels(x, y, w, h, pixels);
+  return w * h;
+}
+
+void TemplateCode::roundFlushArea(lv_disp_drv_t *disp_drv, lv_area_t *area)
+{
+  // FlushDiff compares whole tiles, so widen the area to tile boundaries
+  const lv_coord_t tile = getInstance().flushDiff.tileSize();
+  area->x1 &= ~(tile - 1);
+  area->x2 |= tile - 1;
+  if (area->x2 >= disp_drv->hor_res)
+    area->x2 = disp_drv->hor_res - 1;
+}
+
+void TemplateCode::completeFlush(bool block)
+{
+  if (!pendingFlush)
+    return;
+  if (block)
+  {
+    uint32_t start = micros();
+    panel.waitTransfer();
+    stats.blocked(micros() - start);
+  }
+  else if (!panel.transferDone())
+    return;
+
+  // Completion is polled, so flush time is an upper bound on the transfer time
+  stats.flushFinished(micros());
+  lv_disp_drv_t *drv = pendingFlush;
+  pendingFlush = nullptr;
+  SpiBus::unlock();
+  lv_disp_flush_ready(drv);
+  if (frameInFlight)
+  {
+    frameInFlight = false;
+    if (frameListener)
+      frameListener(frameContext);
+  }
+}
+
+void TemplateCode::waitFlush(lv_disp_drv_t *disp_drv)
+{
+  getInstance().completeFlush(true);
+}
+
+void TemplateCode::monitorRefresh(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px)
+{
+  auto &display = getInstance();
+  display.stats.refreshed(px);
+  display.lastRefreshMs = millis();
+  // Something changed on screen: run at full rate while it keeps changing
+  display.setIdle(false);
+  // Earlier stripes were waited for before the next was flushed, so only the
+  // last one can still be in flight
+  if (display.pendingFlush)
+    display.frameInFlight = true;
+  else if (display.frameListener)
+    display.frameListener(display.frameContext);
+}
+
+void TemplateCode::setFrameListener(void (*listener)(void *context), void *context)
+{
+  frameListener = listener;
+  frameContext = context;
+}
+
+void TemplateCode::setIdle(bool value)
+{
+  if (idle == value)
+    return;
+  idle = value;
+  // An invalidation resumes LVGL's paused refresh timer and, as the timer
+  // last ran long ago, the first frame still renders on the next handler call
+  lv_timer_set_period(_lv_disp_get_refr_timer(disp), idle ? LVGL_IDLE_REFR_PERIOD : LV_DISP_DEF_REFR_PERIOD);
+  lv_timer_set_period(indev_drv.read_timer, idle ? LVGL_IDLE_READ_PERIOD : LV_INDEV_DEF_READ_PERIOD);
+}
+
+bool TemplateCode::touchPending()
+{
+#if defined(MODEL_JC2432W328R)
+  // Set from the XPT2046 IRQ line, no SPI traffic needed
+  return ts.tirqTouched();
+#elif defined(MODEL_JC2432W328C)
+  return touchIrq;
+#elif !defined(ARDUINO)
+  return touchPressed;
+#else
+  return false;
+#endif
 }
 
 #if defined(MODEL_JC2432W328R)
 void TemplateCode::readTouchpad(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 {
   auto &display = getInstance();
+  // Touch shares the VSPI bus with the panel and the SD card
+  SpiBus::Guard bus;
   bool touched = (display.ts.tirqTouched() && display.ts.touched());
 
   if (!touched)
@@ -145,24 +451,24 @@ void TemplateCode::readTouchpad(lv_indev_drv_t *indev_drv, lv_indev_data_t *data
 
   TS_Point p = display.ts.getPoint();
   // Map raw ADC coords into 0..(W-1) / 0..(H-1)
-  int32_t mappedX = map(p.x, TOUCH_X_MIN, TOUCH_X_MAX, 0, SCREEN_WIDTH - 1);
-  int32_t mappedY = map(p.y, TOUCH_Y_MIN, TOUCH_Y_MAX, 0, SCREEN_HEIGHT - 1);
+  int32_t mappedX = map(p.x, TOUCH_X_MIN, TOUCH_X_MAX, 0, display.screenW - 1);
+  int32_t mappedY = map(p.y, TOUCH_Y_MIN, TOUCH_Y_MAX, 0, display.screenH - 1);
 
   // Observation: this board's resistive wiring returns coordinates that are
   // inverted on both axes compared to the LV coordinate frame (top-left -> max,max).
   // Correct by inverting both axes so physical top-left -> (0,0) in LV.
-  int32_t touchX = (SCREEN_WIDTH - 1) - mappedX;
-  int32_t touchY = (SCREEN_HEIGHT - 1) - mappedY;
+  int32_t touchX = (display.screenW - 1) - mappedX;
+  int32_t touchY = (display.screenH - 1) - mappedY;
 
   // Clamp to valid ranges
   if (touchX < 0)
     touchX = 0;
-  if (touchX > (int32_t)SCREEN_WIDTH - 1)
-    touchX = SCREEN_WIDTH - 1;
+  if (touchX > (int32_t)display.screenW - 1)
+    touchX = display.screenW - 1;
   if (touchY < 0)
     touchY = 0;
-  if (touchY > (int32_t)SCREEN_HEIGHT - 1)
-    touchY = SCREEN_HEIGHT - 1;
+  if (touchY > (int32_t)display.screenH - 1)
+    touchY = display.screenH - 1;
 
   data->state = LV_INDEV_STATE_PR;
   data->point.x = (lv_coord_t)touchX;
@@ -182,9 +488,16 @@ void TemplateCode::readTouchpad(lv_indev_drv_t *indev_drv, lv_indev_data_t *data
 }
 #endif
 #if defined(MODEL_JC2432W328C)
+void IRAM_ATTR TemplateCode::onTouchIrq()
+{
+  touchIrq = true;
+}
+
 void TemplateCode::readTouchpad(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 {
   auto &display = getInstance();
+  // Cleared before reading, so a report arriving meanwhile still wakes the next poll
+  touchIrq = false;
   TOUCHINFO ti = {};
   if (display.ts.getSamples(&ti) && ti.count > 0)
   {
@@ -193,12 +506,12 @@ void TemplateCode::readTouchpad(lv_indev_drv_t *indev_drv, lv_indev_data_t *data
     int sy = (int)ti.y[0];
     if (sx < 0)
       sx = 0;
-    if (sx >= (int)SCREEN_WIDTH)
-      sx = SCREEN_WIDTH - 1;
+    if (sx >= (int)display.screenW)
+      sx = display.screenW - 1;
     if (sy < 0)
       sy = 0;
-    if (sy >= (int)SCREEN_HEIGHT)
-      sy = SCREEN_HEIGHT - 1;
+    if (sy >= (int)display.screenH)
+      sy = display.screenH - 1;
     data->state = LV_INDEV_STATE_PR;
     data->point.x = sx;
     data->point.y = sy;
@@ -218,10 +531,137 @@ void TemplateCode::readTouchpad(lv_indev_drv_t *indev_drv, lv_indev_data_t *data
   }
 }
 #endif
+#if !defined(ARDUINO)
+void TemplateCode::readTouchpad(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
+{
+  auto &display = getInstance();
+  data->point = display.touchPoint;
+  data->state = display.touchPressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+}
+
+void TemplateCode::injectTouch(lv_coord_t x, lv_coord_t y, bool pressed)
+{
+  touchPoint.x = x;
+  touchPoint.y = y;
+  touchPressed = pressed;
+}
+
+void TemplateCode::advance(uint32_t ms)
+{
+  const uint32_t step = LV_DISP_DEF_REFR_PERIOD;
+  for (uint32_t done = 0; done < ms; done += step)
+  {
+    hostTickAdvance(ms - done < step ? ms - done : step);
+    update();
+  }
+}
+#endif
 
-void TemplateCode::update()
+uint32_t TemplateCode::update()
 {
-  lv_timer_handler();
+  completeFlush(false);
+
+#if LVGL_ADAPTIVE_REFRESH
+  if (idle && (touchPending() || lv_disp_get_inactive_time(disp) < LVGL_IDLE_AFTER_MS))
+  {
+    // Read the touch now instead of waiting for the slow poll
+    setIdle(false);
+    lv_timer_ready(indev_drv.read_timer);
+  }
+  else if (!idle && lv_disp_get_inactive_time(disp) >= LVGL_IDLE_AFTER_MS &&
+           millis() - lastRefreshMs >= LVGL_IDLE_AFTER_MS)
+  {
+    setIdle(true);
+  }
+#endif
+
+  uint32_t start = micros();
+  uint32_t nextMs = lv_timer_handler();
+  stats.cycleFinished(micros() - start);
+
+  if (statsOverlayMs && millis() - lastOverlayUpdate >= statsOverlayMs)
+  {
+    lastOverlayUpdate = millis();
+    updateStatsOverlay();
+  }
+  return nextMs;
+}
+
+uint32_t TemplateCode::measureFullRedraw()
+{
+  // Measure a real full transfer, not one the flush diff reduces to nothing
+  flushDiff.reset();
+  uint32_t start = micros();
+  lv_obj_invalidate(lv_scr_act());
+  lv_refr_now(nullptr);
+  completeFlush(true);
+  uint32_t elapsed = micros() - start;
+  stats.cycleFinished(elapsed);
+  return elapsed;
+}
+
+void TemplateCode::setStatsOverlay(uint32_t periodMs)
+{
+  statsOverlayMs = periodMs;
+  if (!periodMs && statsLabel)
+  {
+    lv_obj_del(statsLabel);
+    statsLabel = nullptr;
+  }
+}
+
+void TemplateCode::updateStatsOverlay()
+{
+  if (!statsLabel)
+  {
+    // The system layer stays on top of every screen and ignores input
+    statsLabel = lv_label_create(lv_layer_sys());
+    lv_obj_set_style_bg_color(statsLabel, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(statsLabel, LV_OPA_70, 0);
+    lv_obj_set_style_text_color(statsLabel, lv_color_white(), 0);
+    lv_obj_set_style_pad_all(statsLabel, 2, 0);
+    lv_obj_align(statsLabel, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+  }
+
+  char text[80];
+  snprintf(text, sizeof(text), "R %lu us F %lu us\n%lu px %lu KB/s",
+           (unsigned long)stats.lastRenderUs(), (unsigned long)stats.lastFlushUs(),
+           (unsigned long)stats.lastPixels(), (unsigned long)(stats.spiBytesPerSecond() / 1024));
+  if (flushDiff.active())
+  {
+    size_t len = strlen(text);
+    snprintf(text + len, sizeof(text) - len, "\nsaved %lu B", (unsigned long)stats.lastBytesSaved());
+  }
+  lv_label_set_text(statsLabel, text);
+}
+
+namespace
+{
+  void printHistogram(Print &out, const char *name, const Histogram &h)
+  {
+    out.printf("  %-10s n=%lu min=%lu p50=%lu p90=%lu p99=%lu max=%lu mean=%lu\n", name,
+               (unsigned long)h.count(), (unsigned long)h.min(), (unsigned long)h.percentile(50),
+               (unsigned long)h.percentile(90), (unsigned long)h.percentile(99),
+               (unsigned long)h.max(), (unsigned long)h.mean());
+  }
+}
+
+void TemplateCode::printRenderStats(Print &out) const
+{
+  out.printf("Render stats (%lu frames, percentiles are log2 bucket bounds)\n", (unsigned long)stats.frames());
+  printHistogram(out, "render us", stats.renderUs());
+  printHistogram(out, "flush us", stats.flushUs());
+  printHistogram(out, "pixels", stats.pixelsFlushed());
+  printHistogram(out, "dirty px", stats.invalidatedArea());
+  if (flushDiff.active())
+  {
+    printHistogram(out, "saved B", stats.bytesSaved());
+    uint64_t sent = stats.pixelsFlushed().total() * 2;
+    uint64_t saved = stats.bytesSaved().total();
+    out.printf("  diff      %lu%% of invalidated bytes skipped\n",
+               (unsigned long)(sent + saved ? saved * 100 / (sent + saved) : 0));
+  }
+  out.printf("  SPI       %lu KB/s effective\n", (unsigned long)(stats.spiBytesPerSecond() / 1024));
 }
 
 #if LV_USE_LOG != 0
@@ -7,16 +7,25 @@
 #ifndef TEMPLATE_CODE_H
 #define TEMPLATE_CODE_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
 #include <SPI.h>
+#include <esp_heap_caps.h>
+#else
+#include "HostArduino.h"
+#endif
 #include <lvgl.h>
-#include <TFT_eSPI.h>
+#include "PanelDisplay.h"
+#include "RenderStats.h"
+#include "FlushDiff.h"
 #if defined(MODEL_JC2432W328R)
 #include <XPT2046_Touchscreen.h>
 #elif defined(MODEL_JC2432W328C)
 #include <bb_captouch.h>
 #endif
+#ifdef ARDUINO
 #include "RGBledDriver.h"
+#endif
 
 // Pin mapping via PlatformIO build flags (prefer PIO-defined macros)
 #if defined(MODEL_JC2432W328R)
@@ -94,7 +103,8 @@ private:
   // Pins are provided via macros from PlatformIO (see above mapping).
 
   // Screen Configuration (per touch/display orientation)
-  // LVGL expects width x height.
+  // LVGL expects width x height. TFT_ROTATION is the boot orientation;
+  // setRotation() changes it at runtime.
 #ifndef TFT_ROTATION
 #define TFT_ROTATION 0
 #endif
@@ -102,15 +112,13 @@ private:
   // Native panel resolution (ST7789 on CYD): 240x320 (portrait)
   static constexpr uint16_t PANEL_WIDTH = 240;
   static constexpr uint16_t PANEL_HEIGHT = 320;
+  // Longest line in any orientation; line-sized buffers are allocated for this
+  static constexpr uint16_t MAX_LINE = PANEL_WIDTH > PANEL_HEIGHT ? PANEL_WIDTH : PANEL_HEIGHT;
 
-// Derive LVGL resolution from rotation: 0/2 -> portrait, 1/3 -> landscape
-#if (TFT_ROTATION == 0) || (TFT_ROTATION == 2)
-  static constexpr uint16_t SCREEN_WIDTH = PANEL_WIDTH;
-  static constexpr uint16_t SCREEN_HEIGHT = PANEL_HEIGHT;
-#else
-  static constexpr uint16_t SCREEN_WIDTH = PANEL_HEIGHT;
-  static constexpr uint16_t SCREEN_HEIGHT = PANEL_WIDTH;
-#endif
+  // LVGL resolution for the current rotation: 0/2 -> portrait, 1/3 -> landscape
+  uint8_t rotation = TFT_ROTATION & 3;
+  uint16_t screenW = (TFT_ROTATION & 1) ? PANEL_HEIGHT : PANEL_WIDTH;
+  uint16_t screenH = (TFT_ROTATION & 1) ? PANEL_WIDTH : PANEL_HEIGHT;
 
 #if defined(MODEL_JC2432W328R)
 // Touch Calibration Values (overridable via PlatformIO build flags)
@@ -138,11 +146,127 @@ private:
 #if defined(MODEL_JC2432W328C)
   BBCapTouch ts;
 #endif
-  TFT_eSPI tft;
+  // The one display driver stack (backend chosen at compile time, see DisplayHAL.h)
+  PanelDisplay panel;
+
+#if !defined(ARDUINO)
+  // Host builds: pointer state reported on the next input read
+  lv_point_t touchPoint = {0, 0};
+  bool touchPressed = false;
+#endif
+
+  // With LV_COLOR_16_SWAP (lv_conf.h) LVGL renders straight in panel byte
+  // order, so flushing needs no per-pixel byte swap in software. The 8-bit
+  // palette below is built in panel byte order too.
+#if LV_COLOR_16_SWAP || LV_COLOR_DEPTH == 8
+  static constexpr bool SWAP_ON_FLUSH = false;
+#else
+  static constexpr bool SWAP_ON_FLUSH = true;
+#endif
 
-  // LVGL Buffer
+// Draw buffer size (in lines of the boot orientation) and count; also adjustable at
+// boot via setDrawBuffers(). The default keeps the same byte budget at any colour
+// depth, so 8-bit stripes are twice as tall.
+#ifndef LVGL_DRAW_BUF_LINES
+#define LVGL_DRAW_BUF_LINES (PANEL_WIDTH / 10 * 16 / LV_COLOR_DEPTH)
+#endif
+
+#if LV_COLOR_DEPTH == 8
+// 8-bit colour (-DLVGL_COLOR_8BIT=1, see lv_conf.h): LVGL renders RGB332 and
+// flushDisplay() expands each stripe through a 256-entry RGB565 palette into
+// two small DMA buffers of LVGL_EXPAND_LINES lines, sending one while the
+// next is expanded.
+#ifndef LVGL_EXPAND_LINES
+#define LVGL_EXPAND_LINES 8
+#endif
+  static uint16_t palette[256];
+  uint16_t *expandBuf[2] = {nullptr, nullptr};
+  // Capacity of each expansion buffer in pixels
+  uint32_t expandPixels = 0;
+  // expandBuf[] index the last transfer was started from, -1 if none
+  int8_t expandBusy = -1;
+  bool allocateExpandBuffers(uint16_t lines);
+  uint32_t pushExpanded(int32_t x, int32_t y, uint32_t w, uint32_t h, const lv_color_t *pixels);
+#endif
+  // Send a stripe of RGB565 pixels, through the flush diff when enabled; returns pixels sent
+  uint32_t pushStripe(int32_t x, int32_t y, uint32_t w, uint32_t h, uint16_t *pixels);
+#ifndef LVGL_DRAW_BUF_COUNT
+#define LVGL_DRAW_BUF_COUNT (LVGL_DMA_FLUSH ? 2 : 1)
+#endif
+
+  // LVGL Buffers, heap allocated in DMA-capable internal RAM
   static lv_disp_draw_buf_t draw_buf;
-  static lv_color_t buf[SCREEN_WIDTH * SCREEN_HEIGHT / 10];
+  static lv_disp_drv_t disp_drv;
+  static lv_indev_drv_t indev_drv;
+  lv_disp_t *disp = nullptr;
+  lv_color_t *buf = nullptr;
+  lv_color_t *buf2 = nullptr;
+  // Buffer size in pixels; kept across rotations, so stripes change height instead
+  uint32_t bufPixels = 0;
+
+  // Driver whose flush is still being transferred (nullptr when idle)
+  lv_disp_drv_t *pendingFlush = nullptr;
+
+// Skip flushing tiles the panel already shows (see FlushDiff.h). Costs
+// PANEL_WIDTH / LVGL_FLUSH_DIFF_TILE * PANEL_HEIGHT * 4 bytes of RAM plus
+// a hash pass over every flushed pixel; invalidated areas are widened to
+// whole tiles.
+#ifndef LVGL_FLUSH_DIFF
+#define LVGL_FLUSH_DIFF 0
+#endif
+#ifndef LVGL_FLUSH_DIFF_TILE
+#define LVGL_FLUSH_DIFF_TILE 16
+#endif
+
+  FlushDiff flushDiff;
+  static void roundFlushArea(lv_disp_drv_t *disp_drv, lv_area_t *area);
+
+// Live render/flush numbers drawn on the system layer, refreshed every
+// RENDER_STATS_OVERLAY_MS (0 = disabled). The overlay invalidates its own
+// small area on each refresh, which shows up in the stats it reports.
+#ifndef RENDER_STATS_OVERLAY_MS
+#define RENDER_STATS_OVERLAY_MS 0
+#endif
+
+  // Per-frame render/flush instrumentation
+  RenderStats stats;
+  lv_obj_t *statsLabel = nullptr;
+  uint32_t statsOverlayMs = RENDER_STATS_OVERLAY_MS;
+  uint32_t lastOverlayUpdate = 0;
+  void updateStatsOverlay();
+
+// Adaptive refresh: after LVGL_IDLE_AFTER_MS without input or redraws, stretch
+// the refresh and touch polling periods; the first touch or invalidation
+// switches back to the lv_conf.h rates.
+#ifndef LVGL_ADAPTIVE_REFRESH
+#define LVGL_ADAPTIVE_REFRESH 1
+#endif
+#ifndef LVGL_IDLE_AFTER_MS
+#define LVGL_IDLE_AFTER_MS 5000
+#endif
+#ifndef LVGL_IDLE_REFR_PERIOD
+#define LVGL_IDLE_REFR_PERIOD 200
+#endif
+#ifndef LVGL_IDLE_READ_PERIOD
+#define LVGL_IDLE_READ_PERIOD 100
+#endif
+
+  bool idle = false;
+  uint32_t lastRefreshMs = 0;
+  void setIdle(bool value);
+
+  // setFrameListener(): called once each refresh has reached the panel
+  void (*frameListener)(void *context) = nullptr;
+  void *frameContext = nullptr;
+  // A refresh finished rendering while its last stripe was still in flight
+  bool frameInFlight = false;
+  // True if the touch controller has flagged a press that has not been read yet
+  bool touchPending();
+#if defined(MODEL_JC2432W328C)
+  // Latched from the CST820 INT line, cleared when the touch is read
+  static volatile bool touchIrq;
+  static void onTouchIrq();
+#endif
 
   // Singleton instance
   static TemplateCode *instance;
@@ -154,9 +278,18 @@ private:
   void initializeHardware();
   void initializeLVGL();
   void setupTouchscreen();
+  // Point the touch controller's coordinate mapping at the current rotation
+  void applyTouchRotation();
+  // Resize LVGL's top and system layers, which lv_disp_drv_update() leaves alone
+  void resizeLayers();
   static void readTouchpad(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
   void setupDisplay();
 
+  // Signal LVGL once the in-flight transfer has finished
+  void completeFlush(bool block);
+  static void waitFlush(lv_disp_drv_t *disp_drv);
+  static void monitorRefresh(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px);
+
 public:
   // Delete copy constructor and assignment operator
   TemplateCode(const TemplateCode &) = delete;
@@ -177,8 +310,55 @@ public:
   static void debugPrint(const char *buf);
 #endif
 
-  // Periodic tasks
-  void update();
+  // Periodic tasks; returns ms until LVGL next needs servicing
+  uint32_t update();
+  // True while the adaptive refresh has slowed LVGL down
+  bool isIdle() const { return idle; }
+
+  // Invalidate and redraw the whole active screen; returns elapsed microseconds
+  uint32_t measureFullRedraw();
+  // Block until the last flush has reached the panel
+  void waitForFlush() { completeFlush(true); }
+  // Call listener after every refresh, once its last stripe has been flushed
+  // (from LVGL's monitor callback, or when that transfer completes later).
+  // One listener; nullptr removes it.
+  void setFrameListener(void (*listener)(void *context), void *context);
+
+  // Reallocate the draw buffers (lines per buffer, 1 or 2 buffers). Falls back
+  // to fewer lines if DMA-capable RAM runs out; returns false if nothing fits.
+  bool setDrawBuffers(uint16_t lines, uint8_t count);
+  // Stripe height at the current width
+  uint16_t drawBufferLines() const { return (uint16_t)(bufPixels / screenW); }
+  uint8_t drawBufferCount() const { return buf2 ? 2 : 1; }
+  size_t drawBufferBytes() const { return (size_t)bufPixels * sizeof(lv_color_t) * drawBufferCount(); }
+  // DMA RAM used to expand 8-bit stripes to RGB565 (0 at 16-bit depth)
+  size_t expandBufferBytes() const;
+  uint16_t screenWidth() const { return screenW; }
+  uint16_t screenHeight() const { return screenH; }
+
+  // Rotate the panel, touch mapping and LVGL resolution in place (0..3, as
+  // TFT_ROTATION). Screens keep their widgets and are laid out again at the
+  // new size; objects sized in pixels rather than percentages stay as they are.
+  void setRotation(uint8_t rotation);
+  uint8_t getRotation() const { return rotation; }
+
+  // Render/flush histograms collected by update()
+  const RenderStats &renderStats() const { return stats; }
+  void resetRenderStats() { stats.reset(); }
+  // Print the histograms and SPI throughput (e.g. to Serial)
+  void printRenderStats(Print &out) const;
+  // Show or hide the on-screen overlay; refresh period in ms, 0 hides it
+  void setStatsOverlay(uint32_t periodMs);
+
+#if !defined(ARDUINO)
+  // Host builds: the in-memory framebuffer LVGL renders into
+  HostDisplay &hostDisplay() { return panel; }
+  // Host builds: press (or release) the simulated touchscreen at (x, y)
+  void injectTouch(lv_coord_t x, lv_coord_t y, bool pressed);
+  // Host builds: advance the simulated clock by ms, running update() once
+  // per refresh period so LVGL timers, input and redraws all get serviced
+  void advance(uint32_t ms);
+#endif
 };
 
 #endif // TEMPLATE_CODE_H
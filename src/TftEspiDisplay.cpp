@@ -0,0 +1,67 @@
+#include "TftEspiDisplay.h"
+
+#if defined(ARDUINO) && !defined(DISPLAY_BACKEND_LOVYANGFX)
+
+TftEspiDisplay::TftEspiDisplay(uint16_t width, uint16_t height)
+    : tft(width, height)
+{
+}
+
+bool TftEspiDisplay::begin(uint8_t rotation, bool swapBytes)
+{
+  // Also switches the backlight on (TFT_BL / TFT_BACKLIGHT_ON)
+  tft.begin();
+  tft.setRotation(rotation);
+  swap = swapBytes;
+#if LVGL_DMA_FLUSH
+  tft.initDMA();
+  // pushImageDMA() swaps in place when enabled; not needed if LVGL already renders panel order
+  tft.setSwapBytes(swap);
+#endif
+  return true;
+}
+
+void TftEspiDisplay::setRotation(uint8_t rotation)
+{
+  waitTransfer();
+  tft.setRotation(rotation);
+}
+
+void TftEspiDisplay::pushPixels(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *pixels)
+{
+  tft.startWrite();
+  writing = true;
+#if LVGL_DMA_FLUSH
+  // Queued; completion is polled through transferDone()/waitTransfer()
+  tft.pushImageDMA(x, y, w, h, (uint16_t *)pixels);
+#else
+  tft.setAddrWindow(x, y, w, h);
+  tft.pushColors((uint16_t *)pixels, w * h, swap);
+  tft.endWrite();
+  writing = false;
+#endif
+}
+
+bool TftEspiDisplay::transferDone()
+{
+  // TFT_eSPI has no DMA completion callback, so completion is polled
+  if (writing && tft.dmaBusy())
+    return false;
+  if (writing)
+  {
+    tft.endWrite();
+    writing = false;
+  }
+  return true;
+}
+
+void TftEspiDisplay::waitTransfer()
+{
+  if (!writing)
+    return;
+  tft.dmaWait();
+  tft.endWrite();
+  writing = false;
+}
+
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#if defined(ARDUINO) && !defined(DISPLAY_BACKEND_LOVYANGFX)
+
+#include <TFT_eSPI.h>
+#include "DisplayHAL.h"
+
+// TFT_eSPI backend; panel pins and driver come from the build flags (USER_SETUP_LOADED)
+class TftEspiDisplay : public DisplayHAL
+{
+public:
+  // Native (rotation 0) panel resolution; setRotation() swaps axes as needed
+  TftEspiDisplay(uint16_t width, uint16_t height);
+
+  bool begin(uint8_t rotation, bool swapBytes) override;
+  void setRotation(uint8_t rotation) override;
+  void pushPixels(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *pixels) override;
+  bool transferDone() override;
+  void waitTransfer() override;
+
+private:
+  TFT_eSPI tft;
+  bool swap = false;
+  bool writing = false;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include "Theme.h"
+
+namespace
+{
+  bool initialised = false;
+
+  lv_style_t screenStyle;
+  lv_style_t spacingStyle;
+  lv_style_t headerStyle;
+  lv_style_t bareStyle;
+  lv_style_t textStyle;
+  lv_style_t largeTextStyle;
+  lv_style_t mutedTextStyle;
+  lv_style_t listRowStyle;
+  lv_style_t chartStyle;
+  lv_style_t chartPointsStyle;
+  lv_style_t chartLinesStyle;
+}
+
+namespace Theme
+{
+  void init()
+  {
+    if (initialised)
+      return;
+    initialised = true;
+
+    lv_style_init(&screenStyle);
+    lv_style_set_bg_color(&screenStyle, lv_color_hex(0x000000));
+    lv_style_set_pad_all(&screenStyle, 0);
+
+    lv_style_init(&spacingStyle);
+    lv_style_set_pad_all(&spacingStyle, 4);
+    lv_style_set_pad_row(&spacingStyle, 4);
+
+    lv_style_init(&headerStyle);
+    lv_style_set_bg_color(&headerStyle, lv_color_hex(0x1E1E1E));
+    lv_style_set_pad_all(&headerStyle, 5);
+
+    lv_style_init(&bareStyle);
+    lv_style_set_bg_opa(&bareStyle, LV_OPA_TRANSP);
+    lv_style_set_border_width(&bareStyle, 0);
+    lv_style_set_pad_all(&bareStyle, 0);
+
+    lv_style_init(&textStyle);
+    lv_style_set_text_color(&textStyle, lv_color_hex(0xFFFFFF));
+
+    lv_style_init(&largeTextStyle);
+    lv_style_set_text_color(&largeTextStyle, lv_color_hex(0xFFFFFF));
+    lv_style_set_text_font(&largeTextStyle, &lv_font_montserrat_28);
+
+    lv_style_init(&mutedTextStyle);
+    lv_style_set_text_color(&mutedTextStyle, lv_color_hex(0x808080));
+
+    lv_style_init(&listRowStyle);
+    lv_style_set_text_color(&listRowStyle, lv_color_hex(0xFFFFFF));
+    lv_style_set_pad_left(&listRowStyle, 6);
+    lv_style_set_pad_top(&listRowStyle, 4);
+    lv_style_set_border_side(&listRowStyle, LV_BORDER_SIDE_BOTTOM);
+    lv_style_set_border_width(&listRowStyle, 1);
+    lv_style_set_border_color(&listRowStyle, lv_color_hex(0x202020));
+
+    // Dark, borderless and without point markers: lines only, cheapest to draw
+    lv_style_init(&chartStyle);
+    lv_style_set_bg_color(&chartStyle, lv_color_hex(0x101010));
+    lv_style_set_border_width(&chartStyle, 0);
+    lv_style_set_line_color(&chartStyle, lv_color_hex(0x303030));
+
+    lv_style_init(&chartPointsStyle);
+    lv_style_set_size(&chartPointsStyle, 0);
+
+    lv_style_init(&chartLinesStyle);
+    lv_style_set_line_width(&chartLinesStyle, 2);
+  }
+
+  lv_style_t *screen() { return &screenStyle; }
+  lv_style_t *spacing() { return &spacingStyle; }
+  lv_style_t *header() { return &headerStyle; }
+  lv_style_t *bare() { return &bareStyle; }
+  lv_style_t *text() { return &textStyle; }
+  lv_style_t *largeText() { return &largeTextStyle; }
+  lv_style_t *mutedText() { return &mutedTextStyle; }
+  lv_style_t *listRow() { return &listRowStyle; }
+  lv_style_t *chart() { return &chartStyle; }
+  lv_style_t *chartPoints() { return &chartPointsStyle; }
+  lv_style_t *chartLines() { return &chartLinesStyle; }
+
+  void applyChart(lv_obj_t *chart)
+  {
+    lv_obj_add_style(chart, &chartStyle, LV_PART_MAIN);
+    lv_obj_add_style(chart, &chartPointsStyle, LV_PART_INDICATOR);
+    lv_obj_add_style(chart, &chartLinesStyle, LV_PART_ITEMS);
+  }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <lvgl.h>
+
+/**
+ * Shared styles for every screen.
+ *
+ * Each style is a static lv_style_t built once and added to widgets with
+ * lv_obj_add_style(). A widget then holds only a pointer per style, where
+ * lv_obj_set_style_*() gives every widget its own local style and property
+ * array in the LVGL pool. Changing a style here restyles all widgets using it.
+ *
+ * Styles added later take precedence, so a widget can combine a base style
+ * with a more specific one (screen() then spacing()).
+ * StyleCheck measures pool usage and lookup time against local styles.
+ */
+namespace Theme
+{
+  // Build the styles; call once after lv_init(), later calls do nothing
+  void init();
+
+  // Black background, no padding
+  lv_style_t *screen();
+  // Small padding and row gap between flex children
+  lv_style_t *spacing();
+  // Title bar background
+  lv_style_t *header();
+  // Container that only arranges its children: no background, border or padding
+  lv_style_t *bare();
+  // White text in the default font
+  lv_style_t *text();
+  // White text in the large font (captions next to the readings)
+  lv_style_t *largeText();
+  // Secondary text (status lines)
+  lv_style_t *mutedText();
+  // List rows: white text, inset, thin divider below
+  lv_style_t *listRow();
+
+  // Charts: dark background with a faint grid (LV_PART_MAIN), no point
+  // markers (LV_PART_INDICATOR), 2 px series lines (LV_PART_ITEMS)
+  lv_style_t *chart();
+  lv_style_t *chartPoints();
+  lv_style_t *chartLines();
+  // Add the three chart styles to their parts
+  void applyChart(lv_obj_t *chart);
+}
@@ -0,0 +1,68 @@
+#include "TrendChart.h"
+#include "Theme.h"
+
+void TrendChart::create(lv_obj_t *parent)
+{
+  chart = lv_chart_create(parent);
+  lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+  lv_chart_set_point_count(chart, TREND_CHART_POINTS);
+  lv_chart_set_update_mode(chart, TREND_CHART_SWEEP ? LV_CHART_UPDATE_MODE_CIRCULAR : LV_CHART_UPDATE_MODE_SHIFT);
+  lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, TREND_TEMP_MIN, TREND_TEMP_MAX);
+  lv_chart_set_range(chart, LV_CHART_AXIS_SECONDARY_Y, TREND_HUMIDITY_MIN, TREND_HUMIDITY_MAX);
+  lv_chart_set_div_line_count(chart, 3, 0);
+
+  // Dark, borderless and without point markers: lines only, cheapest to draw
+  Theme::applyChart(chart);
+
+  temp = lv_chart_add_series(chart, lv_color_hex(0xFF8C00), LV_CHART_AXIS_PRIMARY_Y);
+  humidity = lv_chart_add_series(chart, lv_color_hex(0x00B4FF), LV_CHART_AXIS_SECONDARY_Y);
+  lv_chart_set_all_value(chart, temp, LV_CHART_POINT_NONE);
+  lv_chart_set_all_value(chart, humidity, LV_CHART_POINT_NONE);
+}
+
+lv_coord_t TrendChart::tempPoint(const LogRecord &rec)
+{
+  return rec.temperature == LOG_TEMP_INVALID ? LV_CHART_POINT_NONE : rec.temperature;
+}
+
+lv_coord_t TrendChart::humidityPoint(const LogRecord &rec)
+{
+  return rec.humidity == LOG_HUMIDITY_INVALID ? LV_CHART_POINT_NONE : (lv_coord_t)rec.humidity;
+}
+
+void TrendChart::append(const LogRecord &rec)
+{
+  if (!chart)
+    return;
+  lv_chart_set_next_value(chart, temp, tempPoint(rec));
+  lv_chart_set_next_value(chart, humidity, humidityPoint(rec));
+#if TREND_CHART_SWEEP
+  // The next slot holds the oldest reading; blank it as the sweep gap. LVGL
+  // has already invalidated the columns around it.
+  uint16_t gap = lv_chart_get_x_start_point(chart, temp);
+  lv_chart_get_y_array(chart, temp)[gap] = LV_CHART_POINT_NONE;
+  lv_chart_get_y_array(chart, humidity)[gap] = LV_CHART_POINT_NONE;
+#endif
+}
+
+void TrendChart::backfill(const LogRecord *records, size_t count)
+{
+  if (!chart || !count)
+    return;
+  lv_coord_t *temps = lv_chart_get_y_array(chart, temp);
+  lv_coord_t *hums = lv_chart_get_y_array(chart, humidity);
+  uint16_t next = lv_chart_get_x_start_point(chart, temp);
+  for (size_t i = 0; i < count; i++)
+  {
+    temps[next] = tempPoint(records[i]);
+    hums[next] = humidityPoint(records[i]);
+    next = (uint16_t)((next + 1) % TREND_CHART_POINTS);
+  }
+#if TREND_CHART_SWEEP
+  temps[next] = LV_CHART_POINT_NONE;
+  hums[next] = LV_CHART_POINT_NONE;
+#endif
+  lv_chart_set_x_start_point(chart, temp, next);
+  lv_chart_set_x_start_point(chart, humidity, next);
+  lv_chart_refresh(chart);
+}
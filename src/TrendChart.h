@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <lvgl.h>
+#include "LogRecord.h"
+
+// Points on the chart: one per logged record (LOG_INTERVAL_MS in LogRecord.h)
+#ifndef TREND_CHART_POINTS
+#define TREND_CHART_POINTS 60
+#endif
+// 1: sweep like a scope trace, a new point only redraws the columns around
+// it. 0: scroll left, every point moves and the whole chart is redrawn.
+#ifndef TREND_CHART_SWEEP
+#define TREND_CHART_SWEEP 1
+#endif
+// Fixed axis ranges in tenths (LogRecord units); fixed so a new reading never rescales the chart
+#ifndef TREND_TEMP_MIN
+#define TREND_TEMP_MIN 0
+#endif
+#ifndef TREND_TEMP_MAX
+#define TREND_TEMP_MAX 400
+#endif
+#ifndef TREND_HUMIDITY_MIN
+#define TREND_HUMIDITY_MIN 0
+#endif
+#ifndef TREND_HUMIDITY_MAX
+#define TREND_HUMIDITY_MAX 1000
+#endif
+
+/**
+ * Temperature and humidity trend on an lv_chart, fed one LogRecord at a time.
+ *
+ * append() writes a single slot per series with lv_chart_set_next_value();
+ * points are never reset or copied. In sweep mode LVGL invalidates only the
+ * columns around the new point, and the slot after it is left empty so the
+ * newest and oldest readings are not joined. backfill() fills the slots in
+ * place from stored history and invalidates the chart once.
+ *
+ * Temperature uses the primary Y axis, humidity the secondary one.
+ */
+class TrendChart
+{
+public:
+  void create(lv_obj_t *parent);
+  lv_obj_t *object() const { return chart; }
+
+  // Add the newest reading; cheap enough to call on every sample
+  void append(const LogRecord &rec);
+  // Load older readings, oldest first; may be called once per chunk
+  void backfill(const LogRecord *records, size_t count);
+
+private:
+  static lv_coord_t tempPoint(const LogRecord &rec);
+  static lv_coord_t humidityPoint(const LogRecord &rec);
+
+  lv_obj_t *chart = nullptr;
+  lv_chart_series_t *temp = nullptr;
+  lv_chart_series_t *humidity = nullptr;
+};
@@ -0,0 +1,241 @@
+#include "UiSuite.h"
+
+#if !defined(ARDUINO)
+
+#include <math.h>
+#include <string.h>
+
+namespace
+{
+  // Long enough for every LVGL timer and the last flush to run
+  const uint32_t SETTLE_MS = 200;
+
+  const UiSuite::Scenario SCENARIOS[] = {
+      {"placeholders", nullptr},
+      {"readings", [](MainInterface &ui)
+       { ui.setTemperature(21.5f); ui.setHumidity(48.0f); }},
+      {"nan", [](MainInterface &ui)
+       { ui.setTemperature(NAN); ui.setHumidity(NAN); }},
+      {"extremes", [](MainInterface &ui)
+       { ui.setTemperature(-40.0f); ui.setHumidity(100.0f); }},
+      {"long_values", [](MainInterface &ui)
+       { ui.setTemperature(123456.7f); ui.setHumidity(99999.9f); }},
+      {"temperature_only", [](MainInterface &ui)
+       { ui.setTemperature(22.0f); }},
+      {"trend_backfill", [](MainInterface &ui)
+       {
+         LogRecord history[TREND_CHART_POINTS];
+         for (int i = 0; i < TREND_CHART_POINTS; i++)
+           history[i] = makeLogRecord(i * 60, 20.0f + 5.0f * sinf(i * 0.2f), 50.0f + 20.0f * cosf(i * 0.1f));
+         ui.trendChart().backfill(history, TREND_CHART_POINTS);
+       }},
+      // Several posts before a frame: only the newest values are drawn, once
+      {"coalesced_posts", [](MainInterface &ui)
+       {
+         for (int i = 0; i < 10; i++)
+         {
+           ui.postTemperature(18.0f + i * 0.5f);
+           ui.postHumidity(40.0f + i);
+         }
+         ui.update();
+       },
+       [](const MainInterface &ui, const RenderStats &update) -> const char *
+       {
+         // 20 posts into two slots: all but the last of each were replaced
+         if (ui.updateQueue().posted() != 20 || ui.updateQueue().coalesced() != 18)
+           return "expected 18 of 20 posts coalesced";
+         if (update.frames() != 1)
+           return "expected the posts to cost a single refresh";
+         return nullptr;
+       }},
+      // Update cost of one new sample: in sweep mode only the columns around it
+      {"trend_append", [](MainInterface &ui)
+       { ui.trendChart().append(makeLogRecord(0, 21.5f, 48.0f)); }},
+  };
+  const int SCENARIO_COUNT = sizeof(SCENARIOS) / sizeof(SCENARIOS[0]);
+}
+
+UiSuite::UiSuite(TemplateCode &templateCode, const char *dir)
+    : display(templateCode), dir(dir)
+{
+}
+
+void UiSuite::path(char *out, size_t size, const char *name, const char *suffix) const
+{
+  snprintf(out, size, "%s/%s%s", dir, name, suffix);
+}
+
+UiSuite::Result UiSuite::runScenario(const Scenario &scenario)
+{
+  Result result = {scenario.name, -1, 0, 0, 0, 0, 0, 0, false, false, nullptr};
+
+  // Each scenario starts from a freshly built screen
+  lv_obj_t *previous = lv_scr_act();
+  MainInterface ui;
+  display.resetRenderStats();
+  ui.init();
+  lv_obj_del(previous);
+  display.advance(SETTLE_MS);
+  display.waitForFlush();
+  result.fullPx = (uint32_t)display.renderStats().invalidatedArea().total();
+  result.fullFlushed = (uint32_t)display.renderStats().pixelsFlushed().total();
+  result.fullUs = (uint32_t)display.renderStats().renderUs().total();
+
+  display.resetRenderStats();
+  if (scenario.apply)
+    scenario.apply(ui);
+  display.advance(SETTLE_MS);
+  display.waitForFlush();
+  result.updatePx = (uint32_t)display.renderStats().invalidatedArea().total();
+  result.updateFlushed = (uint32_t)display.renderStats().pixelsFlushed().total();
+  result.updateUs = (uint32_t)display.renderStats().renderUs().total();
+  if (scenario.check)
+    result.checkFailed = scenario.check(ui, display.renderStats());
+  return result;
+}
+
+int UiSuite::run(bool update)
+{
+  // The overlay would show up in every frame and in the invalidated area
+  display.setStatsOverlay(0);
+  if (!update && !loadBaselines())
+    Serial.printf("No cost baseline in %s (run with --update to create one)\n", dir);
+
+  Result results[SCENARIO_COUNT];
+  int failures = 0;
+  Serial.printf("%-18s %9s %9s %9s %9s %9s %9s %8s  %s\n", "scenario", "full px", "flushed", "update px",
+                "flushed", "full us", "update us", "diff px", "result");
+  for (int i = 0; i < SCENARIO_COUNT; i++)
+  {
+    Result &r = results[i];
+    r = runScenario(SCENARIOS[i]);
+    char file[256];
+    path(file, sizeof(file), r.name, ".ppm");
+
+    const char *verdict = "ok";
+    if (update)
+    {
+      if (!display.hostDisplay().savePPM(file))
+        verdict = "FAIL (cannot write golden)";
+      else if (r.checkFailed)
+        verdict = "FAIL (check)";
+      r.differingPixels = 0;
+    }
+    else
+    {
+      r.differingPixels = display.hostDisplay().diffPPM(file);
+      const Baseline *base = findBaseline(r.name);
+      if (base)
+      {
+        // Pixel counts are the same on every host; render time is not
+        r.costRegressed = r.fullPx > base->fullPx || r.fullFlushed > base->fullFlushed ||
+                          r.updatePx > base->updatePx || r.updateFlushed > base->updateFlushed;
+        r.slower = r.fullUs > (uint64_t)base->fullUs * (100 + timeTolerancePct) / 100 + timeFloorUs ||
+                   r.updateUs > (uint64_t)base->updateUs * (100 + timeTolerancePct) / 100 + timeFloorUs;
+      }
+
+      if (r.differingPixels < 0)
+        verdict = "FAIL (no golden frame)";
+      else if (r.differingPixels > maxDifferingPixels)
+        verdict = "FAIL (image)";
+      else if (!base)
+        verdict = "FAIL (no cost baseline)";
+      else if (r.costRegressed)
+        verdict = "FAIL (cost)";
+      else if (r.checkFailed)
+        verdict = "FAIL (check)";
+      else if (r.slower)
+        verdict = "ok (slower)";
+    }
+
+    if (strncmp(verdict, "FAIL", 4) == 0)
+    {
+      failures++;
+      // Keep the frame that failed next to the golden for inspection
+      path(file, sizeof(file), r.name, ".actual.ppm");
+      display.hostDisplay().savePPM(file);
+    }
+    Serial.printf("%-18s %9lu %9lu %9lu %9lu %9lu %9lu %8ld  %s\n", r.name, (unsigned long)r.fullPx,
+                  (unsigned long)r.fullFlushed, (unsigned long)r.updatePx, (unsigned long)r.updateFlushed,
+                  (unsigned long)r.fullUs, (unsigned long)r.updateUs, r.differingPixels, verdict);
+    if (r.checkFailed)
+      Serial.printf("  %s: %s\n", r.name, r.checkFailed);
+  }
+
+  if (update && !saveBaselines(results, SCENARIO_COUNT))
+  {
+    Serial.printf("Could not write %s/costs.txt\n", dir);
+    failures++;
+  }
+  Serial.printf("%d of %d scenarios failed\n", failures, SCENARIO_COUNT);
+  return failures;
+}
+
+bool UiSuite::hasBaseline() const
+{
+  char file[256];
+  path(file, sizeof(file), "costs", ".txt");
+  FILE *f = fopen(file, "r");
+  if (!f)
+    return false;
+  fclose(f);
+  return true;
+}
+
+const UiSuite::Baseline *UiSuite::findBaseline(const char *name) const
+{
+  for (int i = 0; i < baselineCount; i++)
+    if (strcmp(baselines[i].name, name) == 0)
+      return &baselines[i];
+  return nullptr;
+}
+
+bool UiSuite::loadBaselines()
+{
+  char file[256];
+  path(file, sizeof(file), "costs", ".txt");
+  FILE *f = fopen(file, "r");
+  if (!f)
+    return false;
+
+  char line[128];
+  baselineCount = 0;
+  while (baselineCount < MAX_SCENARIOS && fgets(line, sizeof(line), f))
+  {
+    Baseline &b = baselines[baselineCount];
+    unsigned long fullPx, fullFlushed, updPx, updFlushed, fullUs, updUs;
+    if (line[0] == '#' || sscanf(line, "%31s %lu %lu %lu %lu %lu %lu", b.name, &fullPx, &fullFlushed,
+                                 &updPx, &updFlushed, &fullUs, &updUs) != 7)
+      continue;
+    b.fullPx = (uint32_t)fullPx;
+    b.fullFlushed = (uint32_t)fullFlushed;
+    b.updatePx = (uint32_t)updPx;
+    b.updateFlushed = (uint32_t)updFlushed;
+    b.fullUs = (uint32_t)fullUs;
+    b.updateUs = (uint32_t)updUs;
+    baselineCount++;
+  }
+  fclose(f);
+  return true;
+}
+
+bool UiSuite::saveBaselines(const Result *results, int count) const
+{
+  char file[256];
+  path(file, sizeof(file), "costs", ".txt");
+  FILE *f = fopen(file, "w");
+  if (!f)
+    return false;
+  // Time columns are for reference; only the pixel columns are gated
+  fprintf(f, "# scenario full_px full_flushed update_px update_flushed full_us update_us\n");
+  for (int i = 0; i < count; i++)
+  {
+    const Result &r = results[i];
+    fprintf(f, "%s %lu %lu %lu %lu %lu %lu\n", r.name, (unsigned long)r.fullPx, (unsigned long)r.fullFlushed,
+            (unsigned long)r.updatePx, (unsigned long)r.updateFlushed, (unsigned long)r.fullUs,
+            (unsigned long)r.updateUs);
+  }
+  return fclose(f) == 0;
+}
+
+#endif // !ARDUINO
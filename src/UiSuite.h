@@ -0,0 +1,90 @@
+#pragma once
+
+#if !defined(ARDUINO)
+
+#include <stdint.h>
+#include "TemplateCode.h"
+#include "MainInterface.h"
+
+/**
+ * Rendering regression suite for the host build.
+ *
+ * Each scenario builds a fresh MainInterface, lets the first frame settle,
+ * then applies a state change (readings, NaN, long values, ...). The
+ * settled frame is compared against DIR/<name>.ppm. The cost of the first
+ * frame and of the update is compared against DIR/costs.txt, and a
+ * scenario may assert on the update's render stats (check):
+ * - invalidated and flushed pixels are deterministic and must not grow
+ * - render time depends on the host, so it is only reported; a scenario
+ *   slower than timeTolerancePct (plus a small floor) is marked "slower"
+ *
+ * With update set, the current frames and costs become the new baseline.
+ * The baseline checked in for the main screen is test/ui-golden.
+ */
+class UiSuite
+{
+public:
+  struct Scenario
+  {
+    const char *name;
+    void (*apply)(MainInterface &ui); // nullptr: placeholders only
+    // Optional behavioural assertion on the settled update; returns nullptr
+    // when it holds, otherwise what went wrong
+    const char *(*check)(const MainInterface &ui, const RenderStats &update);
+  };
+
+  struct Result
+  {
+    const char *name;
+    long differingPixels; // -1: no readable golden frame
+    uint32_t fullPx;      // first frame after init(): invalidated area
+    uint32_t fullFlushed; // and pixels sent to the panel
+    uint32_t updatePx;    // frames caused by apply(): invalidated area
+    uint32_t updateFlushed;
+    uint32_t fullUs;      // render time, advisory only
+    uint32_t updateUs;
+    bool costRegressed;
+    bool slower;
+    const char *checkFailed; // message from Scenario::check, nullptr if it held
+  };
+
+  UiSuite(TemplateCode &templateCode, const char *dir);
+
+  // Runs every scenario; returns the number that failed
+  int run(bool update);
+  // Whether DIR holds a recorded baseline (costs.txt) to check against
+  bool hasBaseline() const;
+
+  // Render time growth reported as "slower"; never fails a scenario
+  uint32_t timeTolerancePct = 50;
+  // Absolute slack so tiny updates are not flagged on timer noise
+  uint32_t timeFloorUs = 500;
+  // Pixels allowed to differ from the golden frame
+  long maxDifferingPixels = 0;
+
+private:
+  struct Baseline
+  {
+    char name[32];
+    uint32_t fullPx;
+    uint32_t fullFlushed;
+    uint32_t updatePx;
+    uint32_t updateFlushed;
+    uint32_t fullUs;
+    uint32_t updateUs;
+  };
+
+  Result runScenario(const Scenario &scenario);
+  const Baseline *findBaseline(const char *name) const;
+  bool loadBaselines();
+  bool saveBaselines(const Result *results, int count) const;
+  void path(char *out, size_t size, const char *name, const char *suffix) const;
+
+  TemplateCode &display;
+  const char *dir;
+  static const int MAX_SCENARIOS = 16;
+  Baseline baselines[MAX_SCENARIOS];
+  int baselineCount = 0;
+};
+
+#endif // !ARDUINO
@@ -0,0 +1,40 @@
+#include "UiUpdateQueue.h"
+
+void UiUpdateQueue::lock()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  portENTER_CRITICAL(&mux);
+#endif
+}
+
+void UiUpdateQueue::unlock()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  portEXIT_CRITICAL(&mux);
+#endif
+}
+
+void UiUpdateQueue::post(uint8_t slot, float value)
+{
+  if (slot >= MAX_SLOTS)
+    return;
+  lock();
+  if (pending & (1u << slot))
+    overwritten++;
+  slots[slot] = value;
+  pending |= 1u << slot;
+  posts++;
+  unlock();
+}
+
+uint32_t UiUpdateQueue::take(float values[MAX_SLOTS])
+{
+  lock();
+  uint32_t taken = pending;
+  for (uint8_t i = 0; i < MAX_SLOTS; i++)
+    if (taken & (1u << i))
+      values[i] = slots[i];
+  pending = 0;
+  unlock();
+  return taken;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#endif
+
+/**
+ * Latest-value-wins mailbox between producers and the UI.
+ *
+ * Each slot holds one value. post() overwrites it, from any task or core,
+ * and take() hands the UI everything that changed since the last take(). A
+ * slot posted several times between two frames is applied once, with the
+ * newest value, so it costs one invalidation instead of one per post.
+ *
+ * Slots are numbered by the owner (see MainInterface's UpdateSlot).
+ */
+class UiUpdateQueue
+{
+public:
+  static const uint8_t MAX_SLOTS = 8;
+
+  void post(uint8_t slot, float value);
+  // Copy pending values into values[slot]; returns a bit per slot taken
+  uint32_t take(float values[MAX_SLOTS]);
+
+  // Posts so far, and how many of them were replaced before being applied
+  uint32_t posted() const { return posts; }
+  uint32_t coalesced() const { return overwritten; }
+
+private:
+  void lock();
+  void unlock();
+
+  float slots[MAX_SLOTS] = {};
+  uint32_t pending = 0;
+  uint32_t posts = 0;
+  uint32_t overwritten = 0;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+};
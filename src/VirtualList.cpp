@@ -0,0 +1,160 @@
+#include "VirtualList.h"
+#include "ListWindow.h"
+#include "Theme.h"
+
+void VirtualList::create(lv_obj_t *parent, Fetch fetchCb, void *ctx, lv_coord_t height)
+{
+  fetch = fetchCb;
+  context = ctx;
+  rowHeight = height;
+  rowCount = 0;
+  count = base = 0;
+  rebinds = 0;
+
+  list = lv_obj_create(parent);
+  lv_obj_add_style(list, Theme::bare(), 0);
+  lv_obj_set_scroll_dir(list, LV_DIR_VER);
+  lv_obj_set_scrollbar_mode(list, LV_SCROLLBAR_MODE_OFF);
+
+  // Gives the window its scrollable height; rows are placed over it
+  spacer = lv_obj_create(list);
+  lv_obj_add_style(spacer, Theme::bare(), 0);
+  lv_obj_clear_flag(spacer, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_size(spacer, 1, 0);
+
+  lv_obj_add_event_cb(list, onScroll, LV_EVENT_SCROLL, this);
+  lv_obj_add_event_cb(list, onSizeChanged, LV_EVENT_SIZE_CHANGED, this);
+}
+
+void VirtualList::released()
+{
+  list = spacer = nullptr;
+  for (uint8_t i = 0; i < MAX_ROWS; i++)
+    rows[i] = nullptr;
+  rowCount = 0;
+}
+
+uint32_t VirtualList::windowRows() const
+{
+  return ListWindow::rows(count, base, WINDOW_PX / rowHeight);
+}
+
+void VirtualList::setWindow(uint32_t newBase)
+{
+  base = newBase;
+  lv_obj_set_height(spacer, (lv_coord_t)(windowRows() * rowHeight));
+  for (uint8_t i = 0; i < rowCount; i++)
+    bound[i] = NONE;
+}
+
+void VirtualList::ensureRows()
+{
+  uint32_t needed = ListWindow::poolSize(lv_obj_get_content_height(list), rowHeight, MAX_ROWS);
+  while (rowCount < needed)
+  {
+    lv_obj_t *row = lv_label_create(list);
+    lv_obj_add_style(row, Theme::listRow(), 0);
+    lv_label_set_long_mode(row, LV_LABEL_LONG_CLIP);
+    lv_obj_set_size(row, lv_pct(100), rowHeight);
+    lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+    rows[rowCount++] = row;
+  }
+  // The row for each entry depends on the pool size
+  for (uint8_t i = 0; i < rowCount; i++)
+    bound[i] = NONE;
+}
+
+void VirtualList::setCount(uint32_t newCount, uint32_t inserted)
+{
+  uint32_t oldFirst = first();
+  count = newCount;
+  if (!list)
+    return;
+
+  // At the top the new entries scroll in; anywhere else the view stays put
+  uint32_t wantFirst = oldFirst == 0 ? 0 : oldFirst + inserted;
+  uint32_t newBase = ListWindow::centredBase(wantFirst, count, WINDOW_PX / rowHeight);
+  lv_coord_t offset = lv_obj_get_scroll_y(list) % rowHeight;
+  setWindow(newBase);
+  lv_obj_update_layout(list);
+  recentring = true;
+  lv_obj_scroll_to_y(list, wantFirst > newBase ? (lv_coord_t)((wantFirst - newBase) * rowHeight + offset) : 0,
+                     LV_ANIM_OFF);
+  recentring = false;
+  update(true);
+}
+
+void VirtualList::refresh()
+{
+  update(true);
+}
+
+uint32_t VirtualList::first() const
+{
+  if (!list)
+    return 0;
+  lv_coord_t top = lv_obj_get_scroll_y(list);
+  return base + (top > 0 ? top / rowHeight : 0);
+}
+
+void VirtualList::update(bool refetch)
+{
+  if (!list || !rowCount)
+    return;
+  lv_coord_t top = lv_obj_get_scroll_y(list);
+  if (top < 0)
+    top = 0; // elastic overscroll at the top
+
+  // Re-centre the window before the viewport reaches either end of it
+  if (!recentring)
+  {
+    uint32_t viewRows = lv_obj_get_content_height(list) / rowHeight + 1;
+    uint32_t newBase = ListWindow::recentre(base, top / rowHeight, viewRows, count, WINDOW_PX / rowHeight);
+    if (newBase != base)
+    {
+      // The window keeps its height, so only the scroll position moves
+      lv_coord_t shift = (lv_coord_t)(((int32_t)base - (int32_t)newBase) * rowHeight);
+      setWindow(newBase);
+      recentring = true;
+      lv_obj_scroll_to_y(list, top + shift, LV_ANIM_OFF);
+      recentring = false;
+      top += shift;
+    }
+  }
+
+  uint32_t firstRow = base + top / rowHeight;
+  for (uint32_t k = firstRow; k < firstRow + rowCount; k++)
+  {
+    uint8_t slot = ListWindow::slot(k, rowCount);
+    lv_obj_t *row = rows[slot];
+    if (k >= count)
+    {
+      if (bound[slot] != NONE)
+        lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+      bound[slot] = NONE;
+      continue;
+    }
+    if (bound[slot] == k && !refetch)
+      continue;
+
+    char text[TEXT_SIZE];
+    fetch(k, text, sizeof(text), context);
+    lv_label_set_text(row, text);
+    lv_obj_set_y(row, (lv_coord_t)((k - base) * rowHeight));
+    lv_obj_clear_flag(row, LV_OBJ_FLAG_HIDDEN);
+    bound[slot] = k;
+    rebinds++;
+  }
+}
+
+void VirtualList::onScroll(lv_event_t *e)
+{
+  static_cast<VirtualList *>(lv_event_get_user_data(e))->update(false);
+}
+
+void VirtualList::onSizeChanged(lv_event_t *e)
+{
+  auto *self = static_cast<VirtualList *>(lv_event_get_user_data(e));
+  self->ensureRows();
+  self->update(true);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <lvgl.h>
+
+/**
+ * Scrolling text list that only creates the rows on screen.
+ *
+ * A pool of row labels (one viewport plus two) is reused as the list
+ * scrolls: row k is always shown by label k % rows, so scrolling one row
+ * rebinds one label and fetches one entry; everything else just moves
+ * with LVGL's own scrolling. Entries are fetched on demand through the
+ * Fetch callback, so the list holds no copy of the data.
+ *
+ * lv_coord_t is 16-bit, so the scrollable content covers a window of
+ * WINDOW_PX around the viewport, not the whole list. Near either end of
+ * the window it is re-centred and the scroll position moved by the same
+ * amount, which is invisible and keeps drag and momentum scrolling going.
+ * The scrollbar is off, since it would only show the window.
+ */
+class VirtualList
+{
+public:
+  // Write the text of entry index (0 = first) into text, NUL-terminated
+  using Fetch = void (*)(uint32_t index, char *text, size_t size, void *context);
+
+  static const uint8_t MAX_ROWS = 24;
+  static const uint8_t TEXT_SIZE = 64;
+
+  void create(lv_obj_t *parent, Fetch fetch, void *context, lv_coord_t rowHeight = 24);
+  // The widget tree has been deleted with its screen
+  void released();
+  lv_obj_t *object() const { return list; }
+
+  // Set the number of entries. inserted: how many of them are new at the
+  // front; the rows on screen keep showing the same entries unless the view
+  // is at the top, where the new entries scroll in.
+  void setCount(uint32_t count, uint32_t inserted = 0);
+  uint32_t size() const { return count; }
+  // Fetch every row on screen again
+  void refresh();
+  // Index of the entry at the top of the viewport
+  uint32_t first() const;
+
+  // Rows fetched and rebound since create(), for profiling scroll cost
+  uint32_t binds() const { return rebinds; }
+
+private:
+  static const uint32_t NONE = 0xFFFFFFFFu;
+  static const lv_coord_t WINDOW_PX = 4096;
+
+  void ensureRows();
+  void update(bool refetch);
+  void setWindow(uint32_t newBase);
+  uint32_t windowRows() const;
+  static void onScroll(lv_event_t *e);
+  static void onSizeChanged(lv_event_t *e);
+
+  Fetch fetch = nullptr;
+  void *context = nullptr;
+  lv_obj_t *list = nullptr;
+  lv_obj_t *spacer = nullptr;
+  lv_obj_t *rows[MAX_ROWS] = {};
+  uint32_t bound[MAX_ROWS]; // entry shown by each row, NONE when hidden
+  uint8_t rowCount = 0;
+  lv_coord_t rowHeight = 24;
+  uint32_t count = 0;
+  uint32_t base = 0; // entry at the top of the scrollable window
+  bool recentring = false;
+  uint32_t rebinds = 0;
+};
@@ -14,10 +14,19 @@
 // Import the main interface code for the UI.
 #include "MainInterface.h"
 
-#include <LovyanGFX.hpp>    // Display library: https://github.com/lovyan03/LovyanGFX
 #include "drivers/CST820.h" // Custom I2C driver for CST820 capacitive touchscreen
 #include "PeriodicScheduler.h"
 #include "SensorManager.h"
+#include "FileManager.h"
+#include "HistoryLoader.h"
+#include "EventLog.h"
+#include "LvglMemory.h"
+#ifdef RUN_DISPLAY_BENCHMARK
+#include "DisplayBenchmark.h"
+#endif
+#ifdef RUN_STYLE_CHECK
+#include "StyleCheck.h"
+#endif
 #include <DHT.h>
 
 /**
@@ -27,7 +36,7 @@
 // The reference to the singleton instance
 
 TemplateCode &templateCode = TemplateCode::getInstance();
-MainInterface mainInterface = MainInterface();
+MainInterface mainInterface;
 
 // DHT11 sensor setup (external sensor)
 // Connect DHT11 data pin to GPIO21 or GPIO22 (choose one available)
@@ -42,61 +51,90 @@ PeriodicScheduler scheduler;
 // Manager for sensors - DHT operations are abstracted here
 SensorManager sensorManager(DHTPIN, DHTTYPE, 2000);
 
+// Reading history on SD, or internal flash when no card is fitted
+FileManager fileManager;
+
+// Zoomable history screen data, read on a background task
+size_t fetchHistory(uint32_t index, LogRecord *out, size_t max)
+{
+  return fileManager.readRecords(index, out, max);
+}
+uint32_t countHistory()
+{
+  return fileManager.recordCount();
+}
+HistoryLoader historyLoader(fetchHistory, countHistory);
+
+// Alerts, sensor faults and restarts, derived from the logged readings
+EventLog eventLog;
+// Stored readings scanned for events at startup (default: 7 days)
+#ifndef EVENT_BACKFILL_RECORDS
+#define EVENT_BACKFILL_RECORDS (7UL * 86400000UL / LOG_INTERVAL_MS)
+#endif
+
+// Print the full LVGL memory report every N ms (0 = only when unhealthy)
+#ifndef LVGL_MEM_REPORT_MS
+#define LVGL_MEM_REPORT_MS 0
+#endif
+
+// Print render/flush histograms to Serial every N ms (0 = off)
+#ifndef RENDER_STATS_DUMP_MS
+#define RENDER_STATS_DUMP_MS 0
+#endif
+
 /**
  * --------- Custom user functions ---------
  * Add any custom functions here so the main loop and setup functions are kept clean and easy to read.
  */
 
-// ====== Custom Display Class for ST7789 TFT ======
-class LGFX_JustDisplay : public lgfx::LGFX_Device
+// Pass the newest `records` stored readings to sink, oldest first, in chunks
+void readRecent(uint32_t records, void (*sink)(const LogRecord *data, size_t count))
 {
-  lgfx::Panel_ST7789 _panel; // ST7789 panel instance
-  lgfx::Bus_SPI _bus;        // SPI bus instance
+  // Internal flash: straight from the memory-mapped log, no copies
+  HistoryReader history;
+  if (fileManager.openHistory(history))
+  {
+    uint32_t index = history.count() > records ? history.count() - records : 0;
+    for (RecordSpan span; !(span = history.spanAt(index, records)).empty(); index += span.size)
+      sink(span.data, span.size);
+    return;
+  }
 
-public:
-  LGFX_JustDisplay(void)
+  // SD card: sequential reads through FileManager's open read handle. Chunks
+  // of a few sectors go straight to the card, and a week of readings takes
+  // under a hundred reads. Static: only called from setup(), and kept off the
+  // loop task's stack.
+  static LogRecord chunk[128];
+  const size_t chunkRecords = sizeof(chunk) / sizeof(chunk[0]);
+  uint32_t total = fileManager.recordCount();
+  uint32_t index = total > records ? total - records : 0;
+  while (index < total)
   {
-    { // SPI bus configuration
-      auto cfg = _bus.config();
-      cfg.spi_host = VSPI_HOST;  // Use VSPI (default high-speed SPI)
-      cfg.spi_mode = 0;          // SPI mode 0
-      cfg.freq_write = 27000000; // Write speed: 27 MHz
-      cfg.freq_read = 16000000;  // Read speed (not used here)
-      cfg.spi_3wire = false;
-      cfg.use_lock = true;
-      cfg.dma_channel = 1; // Use DMA channel 1
-      cfg.pin_sclk = 14;   // Clock pin
-      cfg.pin_mosi = 13;   // Data out (MOSI)
-      cfg.pin_miso = -1;   // No data in
-      cfg.pin_dc = 2;      // Data/command pin
-      _bus.config(cfg);
-      _panel.setBus(&_bus);
-    }
-
-    { // Display panel configuration
-      auto cfg = _panel.config();
-      cfg.pin_cs = 15;          // Chip select
-      cfg.pin_rst = -1;         // No reset pin
-      cfg.pin_busy = -1;        // Not used
-      cfg.panel_width = 240;    // Native width
-      cfg.panel_height = 320;   // Native height
-      cfg.offset_rotation = 0;  // No offset
-      cfg.dummy_read_pixel = 8; // For compatibility
-      cfg.dummy_read_bits = 1;
-      cfg.readable = false;
-      cfg.invert = false; // No inversion
-      cfg.rgb_order = 0;  // RGB (not BGR)
-      cfg.dlen_16bit = false;
-      cfg.bus_shared = true;
-      _panel.config(cfg);
-    }
-
-    setPanel(&_panel);
+    size_t n = fileManager.readRecords(index, chunk, chunkRecords);
+    if (n == 0)
+      break;
+    sink(chunk, n);
+    index += n;
   }
-};
+}
 
-// Create display and touch controller instances
-LGFX_JustDisplay tft;
+// Fill the trend chart with the most recent stored readings
+void backfillTrend()
+{
+  readRecent(TREND_CHART_POINTS, [](const LogRecord *records, size_t count)
+             { mainInterface.trendChart().backfill(records, count); });
+}
+
+// Rebuild recent alerts, faults and restarts from stored readings
+void backfillEvents()
+{
+  readRecent(EVENT_BACKFILL_RECORDS, [](const LogRecord *records, size_t count)
+             {
+    for (size_t i = 0; i < count; i++)
+      eventLog.observe(records[i]); });
+}
+
+// Create touch controller instance (the display is owned by TemplateCode)
 CST820 touch(33, 32, 25, 21); // Touch: SDA, SCL, RST, INT
 
 /**
@@ -123,16 +161,43 @@ void setup()
 
   // Initialize the main interface
   mainInterface.init();
+  // Screen switches are timed until their first frame reaches the panel
+  templateCode.setFrameListener(ScreenManager::frameListener, &mainInterface.screenManager());
 
-  // Register callback to update UI when sensors change
+  // Register callback to update UI when sensors change; posted values are
+  // applied by MainInterface::update(), so this may run on any task
   sensorManager.onChange([&](float t, float h)
                          {
-    if (!isnan(t)) mainInterface.setTemperature(t);
-    if (!isnan(h)) mainInterface.setHumidity(h); });
+    if (!isnan(t)) mainInterface.postTemperature(t);
+    if (!isnan(h)) mainInterface.postHumidity(h); });
+
+  // Storage for reading history (commits are batched by the FileManager's CommitPolicy)
+  if (!fileManager.begin())
+    Serial.println("No storage available, readings will not be logged.");
+  else
+  {
+    backfillTrend();
+    backfillEvents();
+    if (historyLoader.begin())
+      mainInterface.setHistoryLoader(&historyLoader);
+  }
+  mainInterface.setEventLog(&eventLog);
 
   // Schedule sensor reads and UI updates
   scheduler.addTask(std::bind(&SensorManager::update, &sensorManager), 2000);
-  scheduler.addTask(std::bind(&MainInterface::update, &mainInterface), 100);
+  // Once per frame: everything posted in between lands in a single redraw
+  scheduler.addTask(std::bind(&MainInterface::update, &mainInterface), LV_DISP_DEF_REFR_PERIOD);
+
+  // Log one reading per interval and let the commit policy decide when to sync
+  scheduler.addTask([]
+                    {
+    LogRecord rec = makeLogRecord(millis() / 1000, sensorManager.lastTemperature(), sensorManager.lastHumidity());
+    // A record that raises an alert, fault or restart is synced right away
+    bool urgent = eventLog.observe(rec);
+    fileManager.appendRecord(rec, urgent);
+    mainInterface.trendChart().append(rec); },
+                    LOG_INTERVAL_MS);
+  scheduler.addTask(std::bind(&FileManager::update, &fileManager), 1000);
 
   /* Add custom setup code here. */
 
@@ -151,18 +216,39 @@ void setup()
   delay(500);
   Serial.println("🧪 Touch + Display test starting...");
 
-  // Enable backlight (GPIO 27 must be HIGH)
-  pinMode(27, OUTPUT);
-  digitalWrite(27, HIGH);
-
-  // Initialize display
-  tft.init();
-  tft.setRotation(1); // Landscape orientation
-  tft.fillScreen(TFT_BLACK);
-  tft.setTextColor(TFT_WHITE);
-  tft.setTextSize(2);
-  tft.setCursor(30, 100);
-  tft.println("Touch to draw");
+  // Full-screen redraw time; build with -DLVGL_DMA_FLUSH=0 to compare against the blocking path
+  Serial.printf("Full redraw: %lu us\n", (unsigned long)templateCode.measureFullRedraw());
+#ifdef RUN_DISPLAY_BENCHMARK
+  DisplayBenchmark::run(templateCode);
+#endif
+#ifdef RUN_STYLE_CHECK
+  StyleCheck::run(templateCode);
+#endif
+  // Startup and benchmark redraws would skew the steady-state histograms
+  templateCode.resetRenderStats();
+  // Startup footprint, the baseline for sizing the pools (LVGL_POOL_SLOTS_*)
+  LvglMemory::printReport(Serial);
+  // Report LVGL memory as soon as a pool overflows, an allocation fails or the heap fragments
+  scheduler.addTask([]
+                    {
+    static bool wasHealthy = true;
+    bool healthy = LvglMemory::healthy();
+    if (!healthy && wasHealthy)
+      LvglMemory::printReport(Serial);
+    wasHealthy = healthy; },
+                    60000);
+#if LVGL_MEM_REPORT_MS
+  scheduler.addTask([]
+                    {
+    LvglMemory::printReport(Serial);
+    mainInterface.screenManager().printReport(Serial); },
+                    LVGL_MEM_REPORT_MS);
+#endif
+#if RENDER_STATS_DUMP_MS
+  scheduler.addTask([]
+                    { templateCode.printRenderStats(Serial); },
+                    RENDER_STATS_DUMP_MS);
+#endif
 
   Serial.println("✅ Setup complete");
 }
@@ -178,12 +264,14 @@ void loop()
 {
 
   // Run the update logic for the template code (includes LVGL handling)
-  templateCode.update();
+  uint32_t lvglNextMs = templateCode.update();
 
   // Sensor reads are handled by SensorManager registered with the PeriodicScheduler
 
   // Scheduler handles periodic sensor reads and UI updates
   scheduler.update();
 
-  delay(10); // Small delay - scheduler controls update frequency
+  // Sleep until LVGL next needs servicing; 10 ms minimum as before, 50 ms at most
+  // so scheduled UI updates still reach the screen promptly while idle
+  delay(lvglNextMs < 10 ? 10 : (lvglNextMs > 50 ? 50 : lvglNextMs));
 }
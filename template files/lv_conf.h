@@ -26,10 +26,16 @@
  *====================*/
 
 /*Color depth: 1 (1 byte per pixel), 8 (RGB332), 16 (RGB565), 32 (ARGB8888)*/
+/*-DLVGL_COLOR_8BIT=1 renders RGB332 to halve the draw buffers; TemplateCode::flushDisplay() expands it to RGB565*/
+#if defined(LVGL_COLOR_8BIT) && LVGL_COLOR_8BIT
+#define LV_COLOR_DEPTH 8
+#else
 #define LV_COLOR_DEPTH 16
+#endif
 
 /*Swap the 2 bytes of RGB565 color. Useful if the display has an 8-bit interface (e.g. SPI)*/
-#define LV_COLOR_16_SWAP 0
+/*Enabled so LVGL renders in ST7789 byte order and TemplateCode::flushDisplay() hands the buffer to SPI untouched*/
+#define LV_COLOR_16_SWAP 1
 
 /*Enable features to draw on transparent background.
  *It's required if opa, and transform_* style properties are used.
@@ -48,7 +54,7 @@
  *=========================*/
 
 /*1: use custom malloc/free, 0: use the built-in `lv_mem_alloc()` and `lv_mem_free()`*/
-#define LV_MEM_CUSTOM 0
+#define LV_MEM_CUSTOM 1
 #if LV_MEM_CUSTOM == 0
     /*Size of the memory available for `lv_mem_alloc()` in bytes (>= 2kB)*/
     #define LV_MEM_SIZE (48U * 1024U)          /*[bytes]*/
@@ -62,10 +68,11 @@
     #endif
 
 #else       /*LV_MEM_CUSTOM*/
-    #define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
-    #define LV_MEM_CUSTOM_ALLOC   malloc
-    #define LV_MEM_CUSTOM_FREE    free
-    #define LV_MEM_CUSTOM_REALLOC realloc
+    /*Size-class pools with usage statistics, see src/LvglMemory.h*/
+    #define LV_MEM_CUSTOM_INCLUDE "LvglMemory.h"   /*Header for the dynamic memory function*/
+    #define LV_MEM_CUSTOM_ALLOC   lvglMemAlloc
+    #define LV_MEM_CUSTOM_FREE    lvglMemFree
+    #define LV_MEM_CUSTOM_REALLOC lvglMemRealloc
 #endif     /*LV_MEM_CUSTOM*/
 
 /*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
@@ -89,8 +96,14 @@
  *It removes the need to manually update the tick with `lv_tick_inc()`)*/
 #define LV_TICK_CUSTOM 1
 #if LV_TICK_CUSTOM
+#ifdef ARDUINO
     #define LV_TICK_CUSTOM_INCLUDE "Arduino.h"         /*Header for the system time function*/
     #define LV_TICK_CUSTOM_SYS_TIME_EXPR (millis())    /*Expression evaluating to current system time in ms*/
+#else
+    /*Host builds ([env:native]): simulated clock advanced by the host program*/
+    #define LV_TICK_CUSTOM_INCLUDE "HostTick.h"
+    #define LV_TICK_CUSTOM_SYS_TIME_EXPR (millis())
+#endif
     /*If using lvgl as ESP32 component*/
     // #define LV_TICK_CUSTOM_INCLUDE "esp_timer.h"
     // #define LV_TICK_CUSTOM_SYS_TIME_EXPR ((esp_timer_get_time() / 1000LL))
@@ -0,0 +1,111 @@
+#include <unity.h>
+#include <string.h>
+#include "TemplateCode.h"
+
+/**
+ * With LV_COLOR_16_SWAP LVGL renders RGB565 in the panel's big-endian byte
+ * order and the flush path sends it unswapped (TemplateCode::SWAP_ON_FLUSH).
+ * These tests pin that down pixel for pixel: the rendered bytes are plain
+ * RGB565 in big-endian order for every colour, and a frame flushed to the
+ * host panel holds exactly the colours that were drawn.
+ */
+
+namespace
+{
+  uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b)
+  {
+    return (uint16_t)((r >> 3) << 11 | (g >> 2) << 5 | (b >> 3));
+  }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_every_colour_is_big_endian_rgb565()
+{
+#if LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP
+  long mismatches = 0;
+  for (uint32_t c = 0; c < 0x10000; c++)
+  {
+    // Top bits of each 8-bit channel carry the 5/6/5 value
+    uint8_t r = (uint8_t)((c >> 11) << 3), g = (uint8_t)(((c >> 5) & 0x3F) << 2), b = (uint8_t)((c & 0x1F) << 3);
+    lv_color_t color = lv_color_make(r, g, b);
+    uint8_t bytes[2];
+    memcpy(bytes, &color, sizeof(bytes));
+    // What the ST7789 expects on the wire: high byte first
+    if (bytes[0] != (uint8_t)(c >> 8) || bytes[1] != (uint8_t)c)
+      mismatches++;
+  }
+  TEST_ASSERT_EQUAL_INT32(0, mismatches);
+#else
+  TEST_IGNORE_MESSAGE("needs LV_COLOR_DEPTH 16 with LV_COLOR_16_SWAP");
+#endif
+}
+
+void test_flushed_frame_has_the_drawn_colours()
+{
+#if LV_COLOR_DEPTH != 16
+  // 8-bit rendering goes through the RGB332 palette and cannot be exact
+  TEST_IGNORE_MESSAGE("needs LV_COLOR_DEPTH 16");
+#endif
+  TemplateCode &display = TemplateCode::getInstance();
+  TEST_ASSERT_TRUE(display.begin());
+  display.setStatsOverlay(0);
+
+  struct Swatch
+  {
+    uint8_t r, g, b;
+  };
+  // Primaries, and colours whose two bytes differ in every bit position
+  const Swatch swatches[] = {
+      {0xFF, 0x00, 0x00},
+      {0x00, 0xFF, 0x00},
+      {0x00, 0x00, 0xFF},
+      {0xFF, 0xFF, 0xFF},
+      {0x12, 0x34, 0x56},
+      {0xA8, 0x5C, 0xF0},
+  };
+  const int count = sizeof(swatches) / sizeof(swatches[0]);
+  const lv_coord_t SIZE = 30;
+
+  lv_obj_t *screen = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(screen, lv_color_black(), 0);
+  for (int i = 0; i < count; i++)
+  {
+    lv_obj_t *box = lv_obj_create(screen);
+    lv_obj_remove_style_all(box);
+    lv_obj_set_style_bg_opa(box, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(box, lv_color_make(swatches[i].r, swatches[i].g, swatches[i].b), 0);
+    lv_obj_set_size(box, SIZE, SIZE);
+    lv_obj_set_pos(box, 5 + i * (SIZE + 5), 5);
+  }
+  lv_obj_t *previous = lv_scr_act();
+  lv_scr_load(screen);
+  lv_obj_del(previous);
+  display.advance(200);
+  display.waitForFlush();
+
+  // The host panel stores what arrived in native-endian RGB565
+  for (int i = 0; i < count; i++)
+  {
+    uint16_t want = rgb565(swatches[i].r, swatches[i].g, swatches[i].b);
+    for (lv_coord_t y = 5; y < 5 + SIZE; y += SIZE - 1)
+      for (lv_coord_t x = 5 + i * (SIZE + 5); x < 5 + i * (SIZE + 5) + SIZE; x += SIZE - 1)
+        TEST_ASSERT_EQUAL_HEX16(want, display.hostDisplay().pixel(x, y));
+  }
+  // and nothing leaked into the gaps
+  TEST_ASSERT_EQUAL_HEX16(0x0000, display.hostDisplay().pixel(5 + SIZE + 2, 5 + SIZE / 2));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_every_colour_is_big_endian_rgb565);
+  RUN_TEST(test_flushed_frame_has_the_drawn_colours);
+  return UNITY_END();
+}
@@ -0,0 +1,122 @@
+#include <unity.h>
+#include "CommitPolicy.h"
+
+namespace
+{
+  const size_t RECORD = 8; // sizeof(LogRecord)
+
+  // Write records one second apart from nowMs until the policy asks for a
+  // commit; returns how many were written
+  uint32_t writeUntilDue(CommitPolicy &policy, uint32_t &nowMs, uint32_t limit)
+  {
+    for (uint32_t n = 1; n <= limit; n++, nowMs += 1000)
+      if (policy.onWrite(RECORD, nowMs))
+        return n;
+    return 0;
+  }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_size_trigger()
+{
+  CommitPolicy policy(64, 3600000);
+  uint32_t now = 0;
+  TEST_ASSERT_EQUAL_UINT32(8, writeUntilDue(policy, now, 100));
+  TEST_ASSERT_EQUAL_INT((int)CommitPolicy::Reason::Size, (int)policy.reason());
+  TEST_ASSERT_EQUAL_UINT32(64, policy.pendingBytes());
+}
+
+void test_count_trigger()
+{
+  CommitPolicy policy(4096, 3600000, 5);
+  uint32_t now = 0;
+  TEST_ASSERT_EQUAL_UINT32(5, writeUntilDue(policy, now, 100));
+  TEST_ASSERT_EQUAL_INT((int)CommitPolicy::Reason::Writes, (int)policy.reason());
+  TEST_ASSERT_EQUAL_UINT32(5, policy.pendingWrites());
+
+  // 0 turns the count trigger off: only size trips here
+  CommitPolicy unlimited(80, 3600000, 0);
+  now = 0;
+  TEST_ASSERT_EQUAL_UINT32(10, writeUntilDue(unlimited, now, 100));
+  TEST_ASSERT_EQUAL_INT((int)CommitPolicy::Reason::Size, (int)unlimited.reason());
+}
+
+void test_age_trigger()
+{
+  CommitPolicy policy(4096, 10000);
+  // Nothing buffered: never due, however long it has been
+  TEST_ASSERT_FALSE(policy.due(1000000));
+
+  TEST_ASSERT_FALSE(policy.onWrite(RECORD, 5000));
+  TEST_ASSERT_FALSE(policy.due(14999));
+  // The age counts from the oldest uncommitted write, not the newest
+  TEST_ASSERT_FALSE(policy.onWrite(RECORD, 12000));
+  TEST_ASSERT_TRUE(policy.due(15000));
+  TEST_ASSERT_EQUAL_INT((int)CommitPolicy::Reason::Time, (int)policy.reason());
+  // A write arriving late trips it as well
+  TEST_ASSERT_TRUE(policy.onWrite(RECORD, 16000));
+  TEST_ASSERT_EQUAL_INT((int)CommitPolicy::Reason::Time, (int)policy.reason());
+
+  // millis() wrapping mid-batch
+  CommitPolicy wrapping(4096, 10000);
+  TEST_ASSERT_FALSE(wrapping.onWrite(RECORD, UINT32_MAX - 2000));
+  TEST_ASSERT_FALSE(wrapping.due(5000));
+  TEST_ASSERT_TRUE(wrapping.due(8000));
+}
+
+void test_priority_trigger()
+{
+  CommitPolicy policy(4096, 3600000, 100);
+  TEST_ASSERT_FALSE(policy.onWrite(RECORD, 0));
+  TEST_ASSERT_TRUE(policy.onWrite(RECORD, 1000, true));
+  TEST_ASSERT_EQUAL_INT((int)CommitPolicy::Reason::Priority, (int)policy.reason());
+  TEST_ASSERT_EQUAL_UINT32(2 * RECORD, policy.pendingBytes());
+}
+
+void test_commit_resets_the_batch()
+{
+  CommitPolicy policy(4096, 10000, 3);
+  uint32_t now = 0;
+  TEST_ASSERT_EQUAL_UINT32(3, writeUntilDue(policy, now, 100));
+  policy.committed(250);
+  TEST_ASSERT_EQUAL_UINT32(0, policy.pendingBytes());
+  TEST_ASSERT_EQUAL_UINT32(0, policy.pendingWrites());
+  TEST_ASSERT_FALSE(policy.due(now + 100000));
+
+  // The next batch starts its own count and age
+  now += 60000;
+  TEST_ASSERT_EQUAL_UINT32(3, writeUntilDue(policy, now, 100));
+  TEST_ASSERT_EQUAL_INT((int)CommitPolicy::Reason::Writes, (int)policy.reason());
+  policy.committed(750, CommitPolicy::Reason::Explicit);
+
+  // Committing with nothing buffered is not counted
+  policy.committed(1000);
+
+  const CommitPolicy::Stats &stats = policy.stats();
+  TEST_ASSERT_EQUAL_UINT32(2, stats.commits);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.byReason[(int)CommitPolicy::Reason::Writes]);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.byReason[(int)CommitPolicy::Reason::Explicit]);
+  TEST_ASSERT_EQUAL_UINT32(6 * RECORD, stats.bytesCommitted);
+  TEST_ASSERT_EQUAL_UINT32(3 * RECORD, stats.avgBytesPerCommit());
+  TEST_ASSERT_EQUAL_UINT32(750, stats.maxLatencyUs);
+  TEST_ASSERT_EQUAL_UINT32(750, stats.lastLatencyUs);
+  TEST_ASSERT_EQUAL_UINT32(500, stats.avgLatencyUs());
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_size_trigger);
+  RUN_TEST(test_count_trigger);
+  RUN_TEST(test_age_trigger);
+  RUN_TEST(test_priority_trigger);
+  RUN_TEST(test_commit_resets_the_batch);
+  return UNITY_END();
+}
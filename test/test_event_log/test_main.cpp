@@ -0,0 +1,173 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "EventLog.h"
+
+namespace
+{
+  // Readings in the alert units (tenths), one a minute
+  LogRecord reading(uint32_t minute, int16_t temp, uint16_t humidity)
+  {
+    return {minute * 60, temp, humidity};
+  }
+
+  void assertEvent(const EventLog &log, uint32_t newest, EventType type, uint32_t timestamp, int16_t value)
+  {
+    Event event;
+    TEST_ASSERT_TRUE(log.get(newest, event));
+    TEST_ASSERT_EQUAL_INT((int)type, (int)event.type);
+    TEST_ASSERT_EQUAL_UINT32(timestamp, event.timestamp);
+    TEST_ASSERT_EQUAL_INT16(value, event.value);
+  }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_normal_readings_raise_nothing()
+{
+  EventLog log;
+  for (uint32_t i = 0; i < 1000; i++)
+    log.observe(reading(i, 215, 480));
+  TEST_ASSERT_EQUAL_UINT32(0, log.count());
+  Event event;
+  TEST_ASSERT_FALSE(log.get(0, event));
+}
+
+void test_temperature_alerts_with_hysteresis()
+{
+  EventLog log;
+  log.observe(reading(0, 200, 500));
+  log.observe(reading(1, ALERT_TEMP_HIGH, 500));
+  // Staying high, and dipping back within the hysteresis, raise nothing more
+  log.observe(reading(2, ALERT_TEMP_HIGH + 20, 500));
+  log.observe(reading(3, ALERT_TEMP_HIGH - ALERT_HYSTERESIS, 500));
+  log.observe(reading(4, ALERT_TEMP_HIGH, 500));
+  TEST_ASSERT_EQUAL_UINT32(1, log.count());
+  log.observe(reading(5, ALERT_TEMP_HIGH - ALERT_HYSTERESIS - 1, 500));
+  TEST_ASSERT_EQUAL_UINT32(2, log.count());
+
+  // Straight from high to low is one event, not a normal in between
+  log.observe(reading(6, ALERT_TEMP_HIGH, 500));
+  log.observe(reading(7, ALERT_TEMP_LOW, 500));
+  log.observe(reading(8, ALERT_TEMP_LOW + ALERT_HYSTERESIS, 500));
+  log.observe(reading(9, ALERT_TEMP_LOW + ALERT_HYSTERESIS + 1, 500));
+
+  TEST_ASSERT_EQUAL_UINT32(5, log.count());
+  assertEvent(log, 4, EventType::TempHigh, 60, ALERT_TEMP_HIGH);
+  assertEvent(log, 3, EventType::TempNormal, 300, ALERT_TEMP_HIGH - ALERT_HYSTERESIS - 1);
+  assertEvent(log, 2, EventType::TempHigh, 360, ALERT_TEMP_HIGH);
+  assertEvent(log, 1, EventType::TempLow, 420, ALERT_TEMP_LOW);
+  assertEvent(log, 0, EventType::TempNormal, 540, ALERT_TEMP_LOW + ALERT_HYSTERESIS + 1);
+}
+
+void test_humidity_alerts_with_hysteresis()
+{
+  EventLog log;
+  log.observe(reading(0, 200, ALERT_HUMIDITY_HIGH));
+  log.observe(reading(1, 200, ALERT_HUMIDITY_HIGH - ALERT_HYSTERESIS));
+  log.observe(reading(2, 200, ALERT_HUMIDITY_HIGH - ALERT_HYSTERESIS - 1));
+  TEST_ASSERT_EQUAL_UINT32(2, log.count());
+  assertEvent(log, 1, EventType::HumidityHigh, 0, ALERT_HUMIDITY_HIGH);
+  assertEvent(log, 0, EventType::HumidityNormal, 120, ALERT_HUMIDITY_HIGH - ALERT_HYSTERESIS - 1);
+}
+
+void test_sensor_faults_restarts_and_empty_slots()
+{
+  EventLog log;
+  log.observe(reading(10, 200, 500));
+  // A run of failed reads is one fault, the first good one a recovery
+  log.observe(makeLogRecord(660, NAN, 50.0f));
+  log.observe(makeLogRecord(720, 20.0f, NAN));
+  log.observe(reading(13, 200, 500));
+  // Erased flash slots are not readings
+  LogRecord empty = {LOG_TIMESTAMP_EMPTY, 0, 0};
+  log.observe(empty);
+  // Seconds since boot going backwards: the device restarted
+  log.observe(reading(1, 200, 500));
+
+  TEST_ASSERT_EQUAL_UINT32(3, log.count());
+  assertEvent(log, 2, EventType::SensorFault, 660, 0);
+  assertEvent(log, 1, EventType::SensorRecovered, 780, 0);
+  assertEvent(log, 0, EventType::Restart, 60, 0);
+}
+
+void test_ring_keeps_the_newest_events()
+{
+  EventLog log;
+  // Every other reading is a fault: one event per reading
+  const uint32_t RAISED = EVENT_LOG_CAPACITY * 2 + 10;
+  for (uint32_t i = 0; i < RAISED; i++)
+    log.observe(i & 1 ? reading(i, 200, 500) : makeLogRecord(i * 60, NAN, NAN));
+  TEST_ASSERT_EQUAL_UINT32(RAISED, log.raised());
+  TEST_ASSERT_EQUAL_UINT32(EVENT_LOG_CAPACITY, log.count());
+  assertEvent(log, 0, EventType::SensorRecovered, (RAISED - 1) * 60, 0);
+  assertEvent(log, EVENT_LOG_CAPACITY - 1, EventType::SensorFault, (RAISED - EVENT_LOG_CAPACITY) * 60, 0);
+  Event event;
+  TEST_ASSERT_FALSE(log.get(EVENT_LOG_CAPACITY, event));
+}
+
+void test_format()
+{
+  char buf[64];
+  Event high = {2 * 86400 + 4 * 3600 + 13 * 60 + 59, 312, EventType::TempHigh};
+  TEST_ASSERT_EQUAL_UINT32(strlen("2d 04:13  Temperature high 31.2°C"), EventLog::format(high, buf, sizeof(buf)));
+  TEST_ASSERT_EQUAL_STRING("2d 04:13  Temperature high 31.2°C", buf);
+
+  Event cold = {59, -15, EventType::TempLow};
+  EventLog::format(cold, buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_STRING("0d 00:00  Temperature low -1.5°C", buf);
+
+  Event humid = {3600, 805, EventType::HumidityHigh};
+  EventLog::format(humid, buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_STRING("0d 01:00  Humidity high 80.5%", buf);
+
+  Event restart = {0, 0, EventType::Restart};
+  TEST_ASSERT_EQUAL_UINT32(19, EventLog::format(restart, buf, sizeof(buf)));
+  TEST_ASSERT_EQUAL_STRING("0d 00:00  Restarted", buf);
+
+  // Too short for the value: the text is kept, the value left off
+  TEST_ASSERT_EQUAL_UINT32(27, EventLog::format(high, buf, 30));
+  TEST_ASSERT_EQUAL_STRING("2d 04:13  Temperature high ", buf);
+  // Too short for the text: truncated and terminated
+  TEST_ASSERT_EQUAL_UINT32(9, EventLog::format(high, buf, 10));
+  TEST_ASSERT_EQUAL_STRING("2d 04:13 ", buf);
+}
+
+void test_alerts_faults_and_restarts_are_urgent()
+{
+  EventLog log;
+  TEST_ASSERT_FALSE(log.observe(reading(0, 200, 500)));
+  TEST_ASSERT_TRUE(log.observe(reading(1, ALERT_TEMP_HIGH, 500)));
+  // Still high: no new event, nothing to sync early
+  TEST_ASSERT_FALSE(log.observe(reading(2, ALERT_TEMP_HIGH + 10, 500)));
+  // Back to normal is logged but can wait for the regular commit
+  TEST_ASSERT_FALSE(log.observe(reading(3, 200, 500)));
+  TEST_ASSERT_TRUE(log.observe(reading(4, ALERT_TEMP_LOW, 500)));
+  TEST_ASSERT_TRUE(log.observe(reading(5, 200, ALERT_HUMIDITY_HIGH)));
+  TEST_ASSERT_FALSE(log.observe(reading(6, 200, 500)));
+  TEST_ASSERT_TRUE(log.observe(makeLogRecord(420, NAN, NAN)));
+  TEST_ASSERT_FALSE(log.observe(makeLogRecord(480, NAN, NAN)));
+  TEST_ASSERT_FALSE(log.observe(reading(9, 200, 500)));
+  TEST_ASSERT_TRUE(log.observe(reading(0, 200, 500)));
+  LogRecord empty = {LOG_TIMESTAMP_EMPTY, 0, 0};
+  TEST_ASSERT_FALSE(log.observe(empty));
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_normal_readings_raise_nothing);
+  RUN_TEST(test_temperature_alerts_with_hysteresis);
+  RUN_TEST(test_humidity_alerts_with_hysteresis);
+  RUN_TEST(test_sensor_faults_restarts_and_empty_slots);
+  RUN_TEST(test_ring_keeps_the_newest_events);
+  RUN_TEST(test_alerts_faults_and_restarts_are_urgent);
+  RUN_TEST(test_format);
+  return UNITY_END();
+}
@@ -0,0 +1,189 @@
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "FixedFormat.h"
+
+/**
+ * FixedFormat against snprintf over every value the sensors and the log can
+ * produce: all int16 tenths, every 0.1 step of the temperature and humidity
+ * ranges with neighbouring floats, and a fixed pseudo-random sample.
+ */
+
+namespace
+{
+  long mismatches = 0;
+  long checks = 0;
+
+  void expect(const char *got, const char *want, const char *what, double value)
+  {
+    checks++;
+    if (strcmp(got, want) == 0)
+      return;
+    if (++mismatches <= 10)
+    {
+      char message[128];
+      snprintf(message, sizeof(message), "%s(%.9g): got \"%s\", want \"%s\"", what, value, got, want);
+      TEST_MESSAGE(message);
+    }
+  }
+
+  // snprintf reference; FixedFormat deliberately drops the sign of a zero result
+  void reference(char *out, size_t size, float value, uint8_t decimals, const char *unit)
+  {
+    char num[48];
+    snprintf(num, sizeof(num), "%.*f", decimals, (double)value);
+    const char *digits = num;
+    if (num[0] == '-' && strspn(num + 1, "0.") == strlen(num + 1))
+      digits = num + 1;
+    snprintf(out, size, "%s%s", digits, unit);
+  }
+
+  void checkFloat(float value, uint8_t decimals, const char *unit)
+  {
+    char got[32], want[64];
+    formatFixed(got, sizeof(got), value, decimals, unit);
+    reference(want, sizeof(want), value, decimals, unit);
+    expect(got, want, "formatFixed", value);
+  }
+
+  // Every 0.1 step from lo to hi (in tenths), as the sensors produce them,
+  // plus the four floats either side of each
+  void sweepTenths(int lo, int hi, const char *unit)
+  {
+    for (int k = lo; k <= hi; k++)
+    {
+      const float candidates[] = {k / 10.0f, k * 0.1f};
+      for (float base : candidates)
+      {
+        float v = base;
+        for (int i = 0; i < 4; i++)
+          v = nextafterf(v, -INFINITY);
+        for (int i = 0; i < 9; i++, v = nextafterf(v, INFINITY))
+          for (uint8_t d = 0; d <= 2; d++)
+            checkFloat(v, d, unit);
+      }
+    }
+  }
+
+  uint32_t lcg(uint32_t &state)
+  {
+    state = state * 1664525u + 1013904223u;
+    return state;
+  }
+}
+
+void setUp()
+{
+  mismatches = 0;
+  checks = 0;
+}
+
+void tearDown()
+{
+}
+
+void test_write_fixed_covers_int16_tenths()
+{
+  char got[32], want[32];
+  for (int32_t v = INT16_MIN; v <= INT16_MAX; v++)
+  {
+    *writeFixed(got, v, 1) = '\0';
+    snprintf(want, sizeof(want), "%.1f", v / 10.0);
+    expect(got, want, "writeFixed", v);
+  }
+  TEST_ASSERT_EQUAL_INT32(0, mismatches);
+}
+
+void test_write_int_and_uint()
+{
+  char got[32], want[32];
+  // Timestamps and other counters
+  for (uint64_t v = 0; v <= UINT32_MAX; v += 65521)
+  {
+    *writeUint(got, (uint32_t)v) = '\0';
+    snprintf(want, sizeof(want), "%lu", (unsigned long)v);
+    expect(got, want, "writeUint", (double)v);
+  }
+  TEST_ASSERT_EQUAL_INT32(0, mismatches);
+
+  *writeUint(got, UINT32_MAX) = '\0';
+  TEST_ASSERT_EQUAL_STRING("4294967295", got);
+  *writeInt(got, INT32_MIN) = '\0';
+  TEST_ASSERT_EQUAL_STRING("-2147483648", got);
+  *writeInt(got, 0) = '\0';
+  TEST_ASSERT_EQUAL_STRING("0", got);
+}
+
+void test_format_fixed_sensor_ranges()
+{
+  // DHT temperature -40..125 C, humidity 0..100 %
+  sweepTenths(-400, 1250, "°C");
+  sweepTenths(0, 1000, "%");
+  TEST_ASSERT_EQUAL_INT32(0, mismatches);
+}
+
+void test_format_fixed_random_sample()
+{
+  // Pseudo-random floats across the temperature range, up to 6 decimals
+  uint32_t seed = 12345;
+  for (int i = 0; i < 1000000; i++)
+  {
+    float v = -40.0f + (lcg(seed) >> 8) * (165.0f / (1 << 24));
+    checkFloat(v, (uint8_t)(lcg(seed) % 7), "");
+  }
+  TEST_ASSERT_EQUAL_INT32(0, mismatches);
+}
+
+void test_format_fixed_padding_invalid_and_truncation()
+{
+  char got[32];
+  TEST_ASSERT_EQUAL_UINT32(8, formatFixed(got, sizeof(got), 5.25f, 1, "%", 8));
+  TEST_ASSERT_EQUAL_STRING("    5.2%", got);
+  formatFixed(got, sizeof(got), 7.0f, 0, "", 3, '0');
+  TEST_ASSERT_EQUAL_STRING("007", got);
+  formatFixed(got, sizeof(got), NAN, 1, "°C");
+  TEST_ASSERT_EQUAL_STRING("--.-°C", got);
+  formatFixed(got, sizeof(got), INFINITY, 2, "");
+  TEST_ASSERT_EQUAL_STRING("--.--", got);
+  formatFixed(got, sizeof(got), 1e12f, 0, "");
+  TEST_ASSERT_EQUAL_STRING("--", got);
+  formatFixed(got, 4, 123.4f, 1, "");
+  TEST_ASSERT_EQUAL_STRING("123", got);
+  formatFixed(got, 1, 123.4f, 1, "");
+  TEST_ASSERT_EQUAL_STRING("", got);
+}
+
+// One decimal with unit, the UI's case; the times are reported, not gated
+void test_format_fixed_speed_against_snprintf()
+{
+  const int ITERATIONS = 1000000;
+  char buf[32];
+  volatile size_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITERATIONS; i++)
+    sink = sink + formatFixed(buf, sizeof(buf), -40.0f + (i % 1650) * 0.1f, 1, "°C");
+  auto middle = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITERATIONS; i++)
+    sink = sink + snprintf(buf, sizeof(buf), "%.1f°C", (double)(-40.0f + (i % 1650) * 0.1f));
+  auto end = std::chrono::steady_clock::now();
+
+  long long fixedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(middle - start).count() / ITERATIONS;
+  long long printfNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - middle).count() / ITERATIONS;
+  char message[96];
+  snprintf(message, sizeof(message), "formatFixed %lld ns/call, snprintf %lld ns/call", fixedNs, printfNs);
+  TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_write_fixed_covers_int16_tenths);
+  RUN_TEST(test_write_int_and_uint);
+  RUN_TEST(test_format_fixed_sensor_ranges);
+  RUN_TEST(test_format_fixed_random_sample);
+  RUN_TEST(test_format_fixed_padding_invalid_and_truncation);
+  RUN_TEST(test_format_fixed_speed_against_snprintf);
+  return UNITY_END();
+}
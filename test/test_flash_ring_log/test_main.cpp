@@ -0,0 +1,261 @@
+#include <unity.h>
+#include <stdlib.h>
+#include <vector>
+#include "FlashRingLog.h"
+#include "SimulatedFlash.h"
+
+namespace
+{
+  const size_t SECTOR = 4096;
+  const size_t PAGE = 256;
+  const size_t SECTORS = 4;
+  // (4096 - 16) / 8
+  const uint32_t RPS = 510;
+
+  // Timestamps double as the record's logical position, so order is checkable
+  LogRecord record(uint32_t n)
+  {
+    LogRecord rec;
+    rec.timestamp = n;
+    rec.temperature = (int16_t)(n % 500) - 100;
+    rec.humidity = (uint16_t)(n % 1000);
+    return rec;
+  }
+
+  void appendRange(FlashRingLog &log, uint32_t from, uint32_t to)
+  {
+    for (uint32_t n = from; n < to; n++)
+      TEST_ASSERT_TRUE(log.append(record(n)));
+  }
+
+  // The stored records are exactly first, first + 1, ... in order
+  void assertRecords(FlashRingLog &log, uint32_t first, uint32_t count)
+  {
+    TEST_ASSERT_EQUAL_UINT32(count, log.count());
+    std::vector<LogRecord> out(count + 1);
+    TEST_ASSERT_EQUAL_UINT32(count, log.read(0, out.data(), count + 1));
+    for (uint32_t i = 0; i < count; i++)
+    {
+      LogRecord want = record(first + i);
+      TEST_ASSERT_EQUAL_UINT32(want.timestamp, out[i].timestamp);
+      TEST_ASSERT_EQUAL_INT16(want.temperature, out[i].temperature);
+      TEST_ASSERT_EQUAL_UINT16(want.humidity, out[i].humidity);
+    }
+  }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_fresh_flash_is_formatted()
+{
+  SimulatedFlash flash(SECTORS * SECTOR, SECTOR, PAGE);
+  FlashRingLog log(flash);
+  TEST_ASSERT_TRUE(log.begin());
+  TEST_ASSERT_TRUE(log.isMounted());
+  TEST_ASSERT_EQUAL_UINT32(RPS, log.recordsPerSector());
+  TEST_ASSERT_EQUAL_UINT32(0, log.count());
+}
+
+void test_pending_records_are_readable_before_flush()
+{
+  SimulatedFlash flash(SECTORS * SECTOR, SECTOR, PAGE);
+  FlashRingLog log(flash);
+  TEST_ASSERT_TRUE(log.begin());
+  appendRange(log, 0, 40);
+  // The first page holds the header and 30 records; 10 are still buffered
+  assertRecords(log, 0, 40);
+  uint32_t programs = flash.programCount();
+  TEST_ASSERT_TRUE(log.flush());
+  TEST_ASSERT_EQUAL_UINT32(programs + 1, flash.programCount());
+  assertRecords(log, 0, 40);
+}
+
+void test_wrap_around_drops_the_oldest_sector()
+{
+  SimulatedFlash flash(SECTORS * SECTOR, SECTOR, PAGE);
+  FlashRingLog log(flash);
+  TEST_ASSERT_TRUE(log.begin());
+
+  // Three passes over the ring and a partly filled head sector
+  const uint32_t total = 3 * SECTORS * RPS + 123;
+  appendRange(log, 0, total);
+  TEST_ASSERT_TRUE(log.flush());
+
+  // The head sector is partly filled and every other sector is full
+  uint32_t kept = (SECTORS - 1) * RPS + 123;
+  assertRecords(log, total - kept, kept);
+  TEST_ASSERT_EQUAL_UINT32(0, flash.violationCount());
+  // Sectors are used in strict ring order, so wear stays within one erase
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, flash.maxEraseCount() - flash.minEraseCount());
+
+  // A reboot finds the same records through the sector headers
+  FlashRingLog remounted(flash);
+  TEST_ASSERT_TRUE(remounted.begin());
+  assertRecords(remounted, total - kept, kept);
+  TEST_ASSERT_EQUAL_UINT32(log.maxEraseCount(), remounted.maxEraseCount());
+
+  // and carries on where the old log stopped
+  appendRange(remounted, total, total + RPS);
+  TEST_ASSERT_TRUE(remounted.flush());
+  assertRecords(remounted, total + RPS - kept, kept);
+  TEST_ASSERT_EQUAL_UINT32(0, flash.violationCount());
+}
+
+void test_torn_final_page_keeps_earlier_records()
+{
+  SimulatedFlash flash(SECTORS * SECTOR, SECTOR, PAGE);
+  FlashRingLog log(flash);
+  TEST_ASSERT_TRUE(log.begin());
+  // Exactly two pages (30 + 32 records), so everything is programmed
+  const uint32_t kept = 62;
+  appendRange(log, 0, kept);
+
+  // Power fails while the third page is programmed: only the first 20 bytes
+  // (two and a half records) reach the flash
+  LogRecord page[32];
+  for (uint32_t i = 0; i < 32; i++)
+    page[i] = record(kept + i);
+  size_t offset = FlashRingLog::HEADER_SIZE + kept * sizeof(LogRecord);
+  TEST_ASSERT_EQUAL_UINT32(0, offset % PAGE);
+  TEST_ASSERT_TRUE(flash.program(offset, page, 20));
+
+  FlashRingLog remounted(flash);
+  TEST_ASSERT_TRUE(remounted.begin());
+  // The complete records survive; the tear adds at most the half-written one
+  uint32_t count = remounted.count();
+  TEST_ASSERT_GREATER_OR_EQUAL(kept + 2, count);
+  TEST_ASSERT_LESS_OR_EQUAL(kept + 3, count);
+  std::vector<LogRecord> out(count);
+  TEST_ASSERT_EQUAL_UINT32(count, remounted.read(0, out.data(), count));
+  for (uint32_t i = 0; i < kept + 2; i++)
+    TEST_ASSERT_EQUAL_UINT32(i, out[i].timestamp);
+
+  // New records go after the torn ones without programming used bytes
+  uint32_t violations = flash.violationCount();
+  for (uint32_t n = 0; n < 100; n++)
+    TEST_ASSERT_TRUE(remounted.append(record(1000 + n)));
+  TEST_ASSERT_TRUE(remounted.flush());
+  TEST_ASSERT_EQUAL_UINT32(violations, flash.violationCount());
+
+  FlashRingLog again(flash);
+  TEST_ASSERT_TRUE(again.begin());
+  TEST_ASSERT_EQUAL_UINT32(count + 100, again.count());
+  LogRecord last;
+  TEST_ASSERT_EQUAL_UINT32(1, again.read(count + 99, &last, 1));
+  TEST_ASSERT_EQUAL_UINT32(1099, last.timestamp);
+}
+
+void test_format_discards_records_and_starts_least_worn()
+{
+  SimulatedFlash flash(SECTORS * SECTOR, SECTOR, PAGE);
+  FlashRingLog log(flash);
+  TEST_ASSERT_TRUE(log.begin());
+  // Sectors 0..2 in use, sector 3 never erased
+  appendRange(log, 0, 2 * RPS + 10);
+  TEST_ASSERT_TRUE(log.flush());
+  TEST_ASSERT_EQUAL_UINT32(0, flash.eraseCount(3));
+
+  TEST_ASSERT_TRUE(log.format());
+  TEST_ASSERT_TRUE(log.isMounted());
+  TEST_ASSERT_EQUAL_UINT32(0, log.count());
+  LogRecord rec;
+  TEST_ASSERT_EQUAL_UINT32(0, log.read(0, &rec, 1));
+
+  // Old sectors were invalidated, so a reboot does not bring them back
+  FlashRingLog remounted(flash);
+  TEST_ASSERT_TRUE(remounted.begin());
+  TEST_ASSERT_EQUAL_UINT32(0, remounted.count());
+
+  // The new ring starts in sector 3 and continues into sector 0. format()
+  // erased 0..2 once to invalidate them; blank sectors are not erased again
+  appendRange(remounted, 5000, 5000 + RPS + 1);
+  TEST_ASSERT_TRUE(remounted.flush());
+  assertRecords(remounted, 5000, RPS + 1);
+  TEST_ASSERT_EQUAL_UINT32(0, flash.violationCount());
+  TEST_ASSERT_EQUAL_UINT32(0, flash.eraseCount(3));
+  TEST_ASSERT_EQUAL_UINT32(1, flash.eraseCount(0));
+  TEST_ASSERT_EQUAL_UINT32(1, flash.eraseCount(1));
+  TEST_ASSERT_EQUAL_UINT32(1, flash.eraseCount(2));
+}
+
+void test_lost_headers_keep_their_wear()
+{
+  SimulatedFlash flash(SECTORS * SECTOR, SECTOR, PAGE);
+  FlashRingLog log(flash);
+  TEST_ASSERT_TRUE(log.begin());
+  // Four passes over the ring: sectors 0..1 erased four times, 2..3 three
+  appendRange(log, 0, 4 * SECTORS * RPS + RPS + 10);
+  TEST_ASSERT_TRUE(log.flush());
+  TEST_ASSERT_EQUAL_UINT32(3, log.minEraseCount());
+  TEST_ASSERT_EQUAL_UINT32(4, log.maxEraseCount());
+
+  // Tear sector 2's header (programming zeros is always allowed)
+  const uint8_t zeros[8] = {};
+  TEST_ASSERT_TRUE(flash.program(2 * SECTOR, zeros, sizeof(zeros)));
+  FlashRingLog remounted(flash);
+  TEST_ASSERT_TRUE(remounted.begin());
+  // Counted as the most worn, not as new
+  TEST_ASSERT_EQUAL_UINT32(3, remounted.minEraseCount());
+  TEST_ASSERT_EQUAL_UINT32(4, remounted.maxEraseCount());
+
+  // format() erases each valid sector once, leaving 0 and 1 at 5 and 3 at
+  // 4, then starts at the first of the least worn: sector 2, which needs its
+  // one erase to clear the torn header
+  TEST_ASSERT_TRUE(remounted.format());
+  appendRange(remounted, 0, 1);
+  TEST_ASSERT_TRUE(remounted.flush());
+  TEST_ASSERT_EQUAL_UINT32(0, flash.violationCount());
+  TEST_ASSERT_EQUAL_UINT32(5, flash.eraseCount(0));
+  TEST_ASSERT_EQUAL_UINT32(5, flash.eraseCount(1));
+  TEST_ASSERT_EQUAL_UINT32(4, flash.eraseCount(2));
+  TEST_ASSERT_EQUAL_UINT32(4, flash.eraseCount(3));
+  TEST_ASSERT_EQUAL_UINT32(5, remounted.maxEraseCount());
+  TEST_ASSERT_EQUAL_UINT32(4, remounted.minEraseCount());
+  FlashRingLog again(flash);
+  TEST_ASSERT_TRUE(again.begin());
+  assertRecords(again, 0, 1);
+}
+
+void test_foreign_data_is_formatted_on_mount()
+{
+  SimulatedFlash flash(SECTORS * SECTOR, SECTOR, PAGE);
+  // Whatever was in the partition before: random bits, no valid headers
+  srand(1);
+  std::vector<uint8_t> noise(PAGE);
+  for (size_t offset = 0; offset < flash.size(); offset += PAGE)
+  {
+    for (uint8_t &b : noise)
+      b = (uint8_t)rand();
+    TEST_ASSERT_TRUE(flash.program(offset, noise.data(), PAGE));
+  }
+
+  FlashRingLog log(flash);
+  TEST_ASSERT_TRUE(log.begin());
+  TEST_ASSERT_EQUAL_UINT32(0, log.count());
+  appendRange(log, 0, 100);
+  TEST_ASSERT_TRUE(log.flush());
+  TEST_ASSERT_EQUAL_UINT32(0, flash.violationCount());
+
+  FlashRingLog remounted(flash);
+  TEST_ASSERT_TRUE(remounted.begin());
+  assertRecords(remounted, 0, 100);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_fresh_flash_is_formatted);
+  RUN_TEST(test_pending_records_are_readable_before_flush);
+  RUN_TEST(test_wrap_around_drops_the_oldest_sector);
+  RUN_TEST(test_torn_final_page_keeps_earlier_records);
+  RUN_TEST(test_format_discards_records_and_starts_least_worn);
+  RUN_TEST(test_lost_headers_keep_their_wear);
+  RUN_TEST(test_foreign_data_is_formatted_on_mount);
+  return UNITY_END();
+}
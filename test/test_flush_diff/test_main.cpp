@@ -0,0 +1,184 @@
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "FlushDiff.h"
+
+namespace
+{
+  const uint16_t W = 320;
+  const uint16_t H = 240;
+  const uint16_t TILE = 16;
+
+  // Records every push into a shadow of the panel's memory
+  class RecordingPanel : public DisplayHAL
+  {
+  public:
+    RecordingPanel() : shown((size_t)W * H, 0) {}
+
+    bool begin(uint8_t, bool) override { return true; }
+    void setRotation(uint8_t) override {}
+    void pushPixels(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *pixels) override
+    {
+      TEST_ASSERT_TRUE(x >= 0 && y >= 0 && x + w <= W && y + h <= H);
+      for (int32_t row = 0; row < h; row++)
+        memcpy(&shown[(size_t)(y + row) * W + x], pixels + (size_t)row * w, w * sizeof(uint16_t));
+      pushes++;
+    }
+    bool transferDone() override { return true; }
+    void waitTransfer() override {}
+
+    std::vector<uint16_t> shown;
+    uint32_t pushes = 0;
+  };
+
+  // Copy a block of the frame into a draw buffer, as LVGL hands it to the flush
+  std::vector<uint16_t> block(const std::vector<uint16_t> &frame, int32_t x, int32_t y, int32_t w, int32_t h)
+  {
+    std::vector<uint16_t> out((size_t)w * h);
+    for (int32_t row = 0; row < h; row++)
+      memcpy(&out[(size_t)row * w], &frame[(size_t)(y + row) * W + x], w * sizeof(uint16_t));
+    return out;
+  }
+
+  // Flush the whole frame in stripes of `rows`; returns the pixels sent
+  uint32_t flushFrame(FlushDiff &diff, RecordingPanel &panel, const std::vector<uint16_t> &frame, int32_t rows)
+  {
+    uint32_t sent = 0;
+    for (int32_t y = 0; y < H; y += rows)
+    {
+      int32_t h = y + rows <= H ? rows : H - y;
+      std::vector<uint16_t> px = block(frame, 0, y, W, h);
+      sent += diff.push(panel, 0, y, W, h, px.data());
+    }
+    return sent;
+  }
+
+  std::vector<uint16_t> noiseFrame(uint32_t seed)
+  {
+    srand(seed);
+    std::vector<uint16_t> frame((size_t)W * H);
+    for (uint16_t &px : frame)
+      px = (uint16_t)rand();
+    return frame;
+  }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_rejects_bad_tile_sizes()
+{
+  FlushDiff diff;
+  TEST_ASSERT_FALSE(diff.begin(W, H, 12));
+  TEST_ASSERT_FALSE(diff.begin(W, H, 1));
+  TEST_ASSERT_FALSE(diff.begin(300, H, 64));
+  TEST_ASSERT_FALSE(diff.active());
+  TEST_ASSERT_TRUE(diff.begin(W, H, TILE));
+  TEST_ASSERT_TRUE(diff.active());
+}
+
+void test_first_frame_is_sent_whole_and_repeat_is_skipped()
+{
+  FlushDiff diff;
+  RecordingPanel panel;
+  TEST_ASSERT_TRUE(diff.begin(W, H, TILE));
+  std::vector<uint16_t> frame = noiseFrame(1);
+
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)W * H, flushFrame(diff, panel, frame, 40));
+  TEST_ASSERT_TRUE(panel.shown == frame);
+
+  uint32_t pushes = panel.pushes;
+  TEST_ASSERT_EQUAL_UINT32(0, flushFrame(diff, panel, frame, 40));
+  TEST_ASSERT_EQUAL_UINT32(pushes, panel.pushes);
+}
+
+void test_changed_tiles_reach_the_panel()
+{
+  FlushDiff diff;
+  RecordingPanel panel;
+  TEST_ASSERT_TRUE(diff.begin(W, H, TILE));
+  std::vector<uint16_t> frame = noiseFrame(2);
+  flushFrame(diff, panel, frame, 40);
+
+  // A small rectangle inside one tile column, and a lone pixel far away
+  for (int32_t y = 50; y < 60; y++)
+    for (int32_t x = 35; x < 40; x++)
+      frame[(size_t)y * W + x] ^= 0xFFFF;
+  frame[(size_t)200 * W + 300] ^= 0x0001;
+
+  uint32_t pushes = panel.pushes;
+  uint32_t sent = flushFrame(diff, panel, frame, 40);
+  TEST_ASSERT_TRUE(panel.shown == frame);
+  // Ten rows of one tile, plus one tile for the pixel
+  TEST_ASSERT_EQUAL_UINT32(11 * TILE, sent);
+  // Rows with the same span go out as one window
+  TEST_ASSERT_EQUAL_UINT32(pushes + 2, panel.pushes);
+}
+
+void test_random_edits_keep_the_panel_in_sync()
+{
+  FlushDiff diff;
+  RecordingPanel panel;
+  TEST_ASSERT_TRUE(diff.begin(W, H, TILE));
+  std::vector<uint16_t> frame = noiseFrame(3);
+  flushFrame(diff, panel, frame, 24);
+
+  srand(4);
+  uint64_t sent = 0;
+  for (int round = 0; round < 200; round++)
+  {
+    // A few rectangles per frame, as widgets redraw
+    for (int r = 0; r < 3; r++)
+    {
+      int32_t x = rand() % W, y = rand() % H;
+      int32_t w = 1 + rand() % 60, h = 1 + rand() % 30;
+      uint16_t colour = (uint16_t)rand();
+      for (int32_t yy = y; yy < y + h && yy < H; yy++)
+        for (int32_t xx = x; xx < x + w && xx < W; xx++)
+          frame[(size_t)yy * W + xx] = colour;
+    }
+    sent += flushFrame(diff, panel, frame, 24);
+    TEST_ASSERT_TRUE(panel.shown == frame);
+  }
+  // Far less than resending every frame
+  TEST_ASSERT_TRUE(sent < 200ULL * W * H / 4);
+}
+
+void test_partial_blocks_and_reset()
+{
+  FlushDiff diff;
+  RecordingPanel panel;
+  TEST_ASSERT_TRUE(diff.begin(W, H, TILE));
+  std::vector<uint16_t> frame = noiseFrame(5);
+  flushFrame(diff, panel, frame, 40);
+
+  // Tile-aligned block inside the screen: unchanged, nothing sent
+  std::vector<uint16_t> px = block(frame, 64, 100, 96, 20);
+  TEST_ASSERT_EQUAL_UINT32(0, diff.push(panel, 64, 100, 96, 20, px.data()));
+
+  // Not tile-aligned: pushed unchanged, whatever the hashes say
+  px = block(frame, 70, 100, 50, 20);
+  TEST_ASSERT_EQUAL_UINT32(50 * 20, diff.push(panel, 70, 100, 50, 20, px.data()));
+
+  // After reset() the panel is unknown, so everything goes out again
+  diff.reset();
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)W * H, flushFrame(diff, panel, frame, 40));
+  TEST_ASSERT_TRUE(panel.shown == frame);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_rejects_bad_tile_sizes);
+  RUN_TEST(test_first_frame_is_sent_whole_and_repeat_is_skipped);
+  RUN_TEST(test_changed_tiles_reach_the_panel);
+  RUN_TEST(test_random_edits_keep_the_panel_in_sync);
+  RUN_TEST(test_partial_blocks_and_reset);
+  return UNITY_END();
+}
@@ -0,0 +1,210 @@
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include "FlashRingLog.h"
+#include "HistoryExporter.h"
+#include "SimulatedFlash.h"
+
+namespace
+{
+  // Collects everything written
+  class StringSink : public ExportSink
+  {
+  public:
+    size_t write(const uint8_t *data, size_t len) override
+    {
+      text.append((const char *)data, len);
+      return len;
+    }
+    std::string text;
+  };
+
+  // Accepts a few bytes at a time and refuses every other call, like a full UART
+  class ThrottledSink : public StringSink
+  {
+  public:
+    size_t write(const uint8_t *data, size_t len) override
+    {
+      if (++calls % 2 == 0)
+        return 0;
+      return StringSink::write(data, len < 7 ? len : 7);
+    }
+    uint32_t calls = 0;
+  };
+
+  // Counts bytes and lines and keeps a running hash, without storing the output
+  class HashSink : public ExportSink
+  {
+  public:
+    size_t write(const uint8_t *data, size_t len) override
+    {
+      for (size_t i = 0; i < len; i++)
+      {
+        hash = (hash ^ data[i]) * 16777619u;
+        if (data[i] == '\n')
+          lines++;
+      }
+      bytes += len;
+      return len;
+    }
+    uint32_t hash = 2166136261u;
+    uint32_t lines = 0;
+    uint64_t bytes = 0;
+  };
+
+  const LogRecord SAMPLE[] = {
+      {60, 215, 480},
+      {120, -5, 1000},
+      {180, LOG_TEMP_INVALID, 455},
+      {240, 1234, LOG_HUMIDITY_INVALID},
+  };
+  const size_t SAMPLE_COUNT = sizeof(SAMPLE) / sizeof(SAMPLE[0]);
+
+  HistoryExporter::BlockFetch sampleFetch()
+  {
+    return [](uint32_t index, LogRecord *scratch, size_t max)
+    {
+      size_t n = 0;
+      for (; n < max && index + n < SAMPLE_COUNT; n++)
+        scratch[n] = SAMPLE[index + n];
+      return RecordSpan{scratch, n};
+    };
+  }
+
+  void runToEnd(HistoryExporter &exporter)
+  {
+    // Bounded, so a stalled export fails instead of hanging the run
+    for (int i = 0; i < 100000 && exporter.pump(); i++)
+    {
+    }
+    TEST_ASSERT_FALSE(exporter.running());
+  }
+
+  // Reference formatting with snprintf, independent of FixedFormat
+  void appendFixed(std::string &out, int32_t scaled)
+  {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%s%ld.%ld", scaled < 0 ? "-" : "", labs(scaled) / 10, labs(scaled) % 10);
+    out += buf;
+  }
+
+  LogRecord syntheticRecord(uint32_t i)
+  {
+    LogRecord rec;
+    rec.timestamp = 1700000000u + i * 60;
+    rec.temperature = i % 997 == 0 ? LOG_TEMP_INVALID : (int16_t)((int32_t)(i % 700) - 200);
+    rec.humidity = i % 991 == 0 ? LOG_HUMIDITY_INVALID : (uint16_t)(i % 1001);
+    return rec;
+  }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_csv_output()
+{
+  StringSink sink;
+  HistoryExporter exporter(sink, HistoryExporter::Format::Csv);
+  exporter.begin(sampleFetch());
+  runToEnd(exporter);
+  TEST_ASSERT_EQUAL_STRING("timestamp,temperature_c,humidity_pct\n"
+                           "60,21.5,48.0\n"
+                           "120,-0.5,100.0\n"
+                           "180,,45.5\n"
+                           "240,123.4,\n",
+                           sink.text.c_str());
+  TEST_ASSERT_EQUAL_UINT32(SAMPLE_COUNT, exporter.recordsExported());
+  TEST_ASSERT_EQUAL_UINT32(sink.text.size(), exporter.bytesWritten());
+}
+
+void test_json_output()
+{
+  StringSink sink;
+  HistoryExporter exporter(sink, HistoryExporter::Format::Json);
+  exporter.begin(sampleFetch(), 1, 2);
+  runToEnd(exporter);
+  TEST_ASSERT_EQUAL_STRING("[\n"
+                           "{\"timestamp\":120,\"temperature\":-0.5,\"humidity\":100.0},\n"
+                           "{\"timestamp\":180,\"temperature\":null,\"humidity\":45.5}\n"
+                           "]\n",
+                           sink.text.c_str());
+}
+
+void test_backpressure_resumes_at_the_same_byte()
+{
+  StringSink direct;
+  HistoryExporter reference(direct, HistoryExporter::Format::Json);
+  reference.begin(sampleFetch());
+  runToEnd(reference);
+
+  ThrottledSink slow;
+  HistoryExporter exporter(slow, HistoryExporter::Format::Json);
+  exporter.begin(sampleFetch());
+  runToEnd(exporter);
+  TEST_ASSERT_EQUAL_STRING(direct.text.c_str(), slow.text.c_str());
+}
+
+// A million records from a simulated flash ring log, checked byte for byte
+// against snprintf output; the time is reported, not gated
+void test_million_records_from_flash()
+{
+  const uint32_t RECORDS = 1000000;
+  SimulatedFlash flash(2100 * 4096);
+  FlashRingLog log(flash);
+  TEST_ASSERT_TRUE(log.begin());
+  for (uint32_t i = 0; i < RECORDS; i++)
+    TEST_ASSERT_TRUE(log.append(syntheticRecord(i)));
+  TEST_ASSERT_TRUE(log.flush());
+  TEST_ASSERT_EQUAL_UINT32(RECORDS, log.count());
+  TEST_ASSERT_EQUAL_UINT32(0, flash.violationCount());
+
+  HashSink expected;
+  std::string line = "timestamp,temperature_c,humidity_pct\n";
+  expected.write((const uint8_t *)line.data(), line.size());
+  for (uint32_t i = 0; i < RECORDS; i++)
+  {
+    LogRecord rec = syntheticRecord(i);
+    line = std::to_string(rec.timestamp) + ",";
+    if (rec.temperature != LOG_TEMP_INVALID)
+      appendFixed(line, rec.temperature);
+    line += ",";
+    if (rec.humidity != LOG_HUMIDITY_INVALID)
+      appendFixed(line, rec.humidity);
+    line += "\n";
+    expected.write((const uint8_t *)line.data(), line.size());
+  }
+
+  HashSink sink;
+  HistoryExporter exporter(sink, HistoryExporter::Format::Csv);
+  exporter.begin([&log](uint32_t index, LogRecord *scratch, size_t max)
+                 { return RecordSpan{scratch, log.read(index, scratch, max)}; });
+  auto start = std::chrono::steady_clock::now();
+  runToEnd(exporter);
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+  TEST_ASSERT_EQUAL_UINT32(RECORDS, exporter.recordsExported());
+  TEST_ASSERT_EQUAL_UINT32(RECORDS + 1, sink.lines);
+  TEST_ASSERT_TRUE(expected.bytes == sink.bytes);
+  TEST_ASSERT_EQUAL_HEX32(expected.hash, sink.hash);
+
+  char message[96];
+  snprintf(message, sizeof(message), "1M records, %llu bytes of CSV in %lld ms",
+           (unsigned long long)sink.bytes, (long long)ms);
+  TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_csv_output);
+  RUN_TEST(test_json_output);
+  RUN_TEST(test_backpressure_resumes_at_the_same_byte);
+  RUN_TEST(test_million_records_from_flash);
+  return UNITY_END();
+}
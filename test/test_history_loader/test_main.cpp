@@ -0,0 +1,269 @@
+#include <unity.h>
+#include <vector>
+#include "HistoryLoader.h"
+
+namespace
+{
+  // The store the loader reads; Fetch and Count are plain function pointers
+  std::vector<LogRecord> store;
+  uint32_t failFrom = UINT32_MAX; // fetches at or past this index fail
+  uint32_t fetched = 0;           // records read so far
+
+
+  size_t fetchStore(uint32_t index, LogRecord *out, size_t max)
+  {
+    size_t n = 0;
+    for (; n < max && index + n < store.size() && index + n < failFrom; n++)
+      out[n] = store[index + n];
+    fetched += n;
+    return n;
+  }
+
+  uint32_t countStore() { return (uint32_t)store.size(); }
+
+  // Temperatures swing through zero so rounding of negative means is covered
+  LogRecord record(uint32_t i)
+  {
+    LogRecord rec;
+    rec.timestamp = i * 60;
+    rec.temperature = i % 50 == 7 ? LOG_TEMP_INVALID : (int16_t)((int32_t)(i * 37 % 401) - 200);
+    rec.humidity = i % 70 == 3 ? LOG_HUMIDITY_INVALID : (uint16_t)(i * 13 % 1001);
+    return rec;
+  }
+
+  void fill(uint32_t records)
+  {
+    store.clear();
+    for (uint32_t i = 0; i < records; i++)
+      store.push_back(record(i));
+  }
+
+  // Mean of the valid values, rounded half away from zero
+  int32_t expectedMean(uint32_t from, uint32_t to, bool temperature)
+  {
+    int64_t sum = 0;
+    int64_t n = 0;
+    for (uint32_t i = from; i < to; i++)
+    {
+      if (temperature && store[i].temperature != LOG_TEMP_INVALID)
+        sum += store[i].temperature, n++;
+      if (!temperature && store[i].humidity != LOG_HUMIDITY_INVALID)
+        sum += store[i].humidity, n++;
+    }
+    if (!n)
+      return temperature ? LOG_TEMP_INVALID : LOG_HUMIDITY_INVALID;
+    return (int32_t)(sum >= 0 ? (sum + n / 2) / n : (sum - n / 2) / n);
+  }
+
+  void assertExact(const HistoryView &view, uint32_t end)
+  {
+    TEST_ASSERT_TRUE(view.complete());
+    for (uint16_t p = 0; p < view.points; p++)
+    {
+      uint32_t from = view.first + p * view.perPoint;
+      uint32_t to = from + view.perPoint < end ? from + view.perPoint : end;
+      TEST_ASSERT_EQUAL_INT16(expectedMean(from, to, true), view.temperature[p]);
+      TEST_ASSERT_EQUAL_UINT16(expectedMean(from, to, false), view.humidity[p]);
+    }
+  }
+
+  // Run to completion, keeping the last view taken
+  uint32_t drain(HistoryLoader &loader, HistoryView &view, uint32_t budget)
+  {
+    uint32_t takes = 0;
+    for (int i = 0; i < 100000 && !view.complete(); i++)
+    {
+      loader.poll(budget);
+      if (loader.take(view))
+        takes++;
+    }
+    return takes;
+  }
+}
+
+void setUp()
+{
+  store.clear();
+  failFrom = UINT32_MAX;
+  fetched = 0;
+}
+
+void tearDown()
+{
+}
+
+void test_empty_store_publishes_an_empty_view()
+{
+  HistoryLoader loader(fetchStore, countStore);
+  TEST_ASSERT_TRUE(loader.begin());
+  uint32_t gen = loader.request(1000, 0, 100);
+  loader.poll(100);
+  HistoryView view;
+  TEST_ASSERT_TRUE(loader.take(view));
+  TEST_ASSERT_EQUAL_UINT32(gen, view.generation);
+  TEST_ASSERT_EQUAL_UINT16(0, view.points);
+  TEST_ASSERT_FALSE(loader.take(view));
+}
+
+void test_coarse_view_first_then_exact_means()
+{
+  fill(10000);
+  HistoryLoader loader(fetchStore, countStore);
+  uint32_t gen = loader.request(4500, 0, 150);
+
+  // The coarse pass needs one record per point
+  HistoryView view;
+  loader.poll(150);
+  TEST_ASSERT_TRUE(loader.take(view));
+  TEST_ASSERT_EQUAL_UINT32(gen, view.generation);
+  TEST_ASSERT_EQUAL_UINT32(5500, view.first);
+  TEST_ASSERT_EQUAL_UINT32(30, view.perPoint);
+  TEST_ASSERT_EQUAL_UINT16(150, view.points);
+  TEST_ASSERT_EQUAL_UINT16(0, view.refinedPoints);
+  TEST_ASSERT_EQUAL_INT16(store[5500 + 15].temperature, view.temperature[0]);
+
+  // Refinement publishes in batches until every point is exact
+  uint32_t takes = drain(loader, view, 100);
+  TEST_ASSERT_TRUE(takes > 1);
+  TEST_ASSERT_EQUAL_UINT32(10000, loader.total());
+  assertExact(view, 10000);
+}
+
+void test_window_ending_before_the_newest()
+{
+  fill(5000);
+  HistoryLoader loader(fetchStore, countStore);
+  loader.request(1000, 300, 160);
+  HistoryView view;
+  drain(loader, view, 1000);
+  TEST_ASSERT_EQUAL_UINT32(3700, view.first);
+  // 1000 records at 160 points: 7 records a point, the last one short
+  TEST_ASSERT_EQUAL_UINT32(7, view.perPoint);
+  TEST_ASSERT_EQUAL_UINT16(143, view.points);
+  assertExact(view, 4700);
+}
+
+void test_short_window_is_exact_after_the_coarse_pass()
+{
+  fill(50);
+  HistoryLoader loader(fetchStore, countStore);
+  // More points than records (and than MAX_POINTS): one record per point
+  loader.request(1000, 0, 500);
+  HistoryView view;
+  loader.poll(50);
+  TEST_ASSERT_TRUE(loader.take(view));
+  TEST_ASSERT_EQUAL_UINT16(50, view.points);
+  TEST_ASSERT_EQUAL_UINT32(1, view.perPoint);
+  assertExact(view, 50);
+  loader.poll(50);
+  TEST_ASSERT_FALSE(loader.take(view));
+}
+
+void test_new_request_supersedes_the_current_one()
+{
+  fill(20000);
+  HistoryLoader loader(fetchStore, countStore);
+  loader.request(20000, 0, 160);
+  loader.poll(500);
+
+  // Nothing of the first request is taken once a second one is asked for
+  uint32_t gen = loader.request(600, 0, 60);
+  HistoryView view;
+  TEST_ASSERT_FALSE(loader.take(view));
+  drain(loader, view, 64);
+  TEST_ASSERT_EQUAL_UINT32(gen, view.generation);
+  TEST_ASSERT_EQUAL_UINT32(19400, view.first);
+  TEST_ASSERT_EQUAL_UINT32(10, view.perPoint);
+  assertExact(view, 20000);
+}
+
+void test_unreadable_records_are_skipped()
+{
+  fill(3000);
+  failFrom = 2000;
+  HistoryLoader loader(fetchStore, countStore);
+  loader.request(3000, 0, 60);
+  HistoryView view;
+  drain(loader, view, 256);
+  TEST_ASSERT_TRUE(view.complete());
+  TEST_ASSERT_EQUAL_UINT16(60, view.points);
+  TEST_ASSERT_EQUAL_INT16(expectedMean(1950, 2000, true), view.temperature[39]);
+  // Points that could not be read at all come out invalid, not stuck
+  TEST_ASSERT_EQUAL_INT16(LOG_TEMP_INVALID, view.temperature[40]);
+  TEST_ASSERT_EQUAL_UINT16(LOG_HUMIDITY_INVALID, view.humidity[59]);
+}
+
+void test_wide_points_are_whole_buckets()
+{
+  fill(50000);
+  HistoryLoader loader(fetchStore, countStore);
+  // 30 days at 150 points: 288 records a point, widened to 5 buckets and
+  // the start moved back to the bucket boundary at or before 6800
+  loader.request(43200, 0, 150);
+  HistoryView view;
+  drain(loader, view, 256);
+  TEST_ASSERT_EQUAL_UINT32(6780, view.first);
+  TEST_ASSERT_EQUAL_UINT32(5 * HistoryLoader::BUCKET, view.perPoint);
+  TEST_ASSERT_EQUAL_UINT16(145, view.points);
+  assertExact(view, 50000);
+}
+
+void test_cached_buckets_are_not_read_again()
+{
+  fill(50000);
+  HistoryLoader loader(fetchStore, countStore);
+  loader.request(43200, 0, 150);
+  HistoryView view;
+  drain(loader, view, 256);
+  uint32_t firstLoad = fetched;
+  TEST_ASSERT_TRUE(firstLoad >= 43200);
+
+  // Same span again, then panned back a day: one check read per cached bucket
+  // (plus the coarse pass and the uncached ends)
+  fetched = 0;
+  view = HistoryView();
+  loader.request(43200, 0, 150);
+  drain(loader, view, 256);
+  assertExact(view, 50000);
+  TEST_ASSERT_TRUE(fetched < firstLoad / 20);
+
+  fetched = 0;
+  view = HistoryView();
+  loader.request(43200, 1440, 150);
+  drain(loader, view, 256);
+  assertExact(view, 50000 - 1440);
+  TEST_ASSERT_TRUE(fetched < firstLoad / 10);
+}
+
+void test_cache_survives_the_oldest_records_being_dropped()
+{
+  fill(20000);
+  HistoryLoader loader(fetchStore, countStore);
+  loader.request(20000, 0, 100);
+  HistoryView view;
+  drain(loader, view, 256);
+
+  // A full ring drops its oldest records: every logical index moves
+  store.erase(store.begin(), store.begin() + 1000);
+  for (uint32_t i = 20000; i < 21000; i++)
+    store.push_back(record(i));
+  view = HistoryView();
+  loader.request(20000, 0, 100);
+  drain(loader, view, 256);
+  assertExact(view, 20000);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_store_publishes_an_empty_view);
+  RUN_TEST(test_coarse_view_first_then_exact_means);
+  RUN_TEST(test_window_ending_before_the_newest);
+  RUN_TEST(test_short_window_is_exact_after_the_coarse_pass);
+  RUN_TEST(test_new_request_supersedes_the_current_one);
+  RUN_TEST(test_unreadable_records_are_skipped);
+  RUN_TEST(test_wide_points_are_whole_buckets);
+  RUN_TEST(test_cached_buckets_are_not_read_again);
+  RUN_TEST(test_cache_survives_the_oldest_records_being_dropped);
+  return UNITY_END();
+}
@@ -0,0 +1,151 @@
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "FlashRingLog.h"
+#include "HistoryReader.h"
+#include "SimulatedFlash.h"
+
+namespace
+{
+  const size_t SECTOR = 4096;
+  const size_t SECTORS = 6;
+  const uint32_t RPS = (SECTOR - FlashRingLog::HEADER_SIZE) / sizeof(LogRecord);
+
+  char imagePath[32];
+
+  LogRecord record(uint32_t n)
+  {
+    LogRecord rec;
+    rec.timestamp = n;
+    rec.temperature = (int16_t)(n % 400);
+    rec.humidity = (uint16_t)(n % 1000);
+    return rec;
+  }
+
+  void appendRange(FlashRingLog &log, uint32_t from, uint32_t to)
+  {
+    for (uint32_t n = from; n < to; n++)
+      TEST_ASSERT_TRUE(log.append(record(n)));
+    TEST_ASSERT_TRUE(log.flush());
+  }
+}
+
+void setUp()
+{
+  // A partition image file for the reader to mmap()
+  strcpy(imagePath, "/tmp/historyXXXXXX");
+  int fd = mkstemp(imagePath);
+  TEST_ASSERT_TRUE(fd >= 0);
+  close(fd);
+}
+
+void tearDown()
+{
+  unlink(imagePath);
+}
+
+void test_blank_image_is_empty()
+{
+  SimulatedFlash flash(SECTORS * SECTOR, SECTOR);
+  TEST_ASSERT_TRUE(flash.saveImage(imagePath));
+
+  HistoryReader reader;
+  TEST_ASSERT_TRUE(reader.open(imagePath, SECTOR));
+  TEST_ASSERT_EQUAL_UINT32(0, reader.count());
+  TEST_ASSERT_EQUAL_UINT32(0, reader.blockCount());
+  TEST_ASSERT_TRUE(reader.spanAt(0, 10).empty());
+}
+
+void test_missing_image_fails_to_open()
+{
+  HistoryReader reader;
+  TEST_ASSERT_FALSE(reader.open("/nonexistent/history.img", SECTOR));
+  TEST_ASSERT_FALSE(reader.isOpen());
+}
+
+void test_spans_match_the_ring_log()
+{
+  SimulatedFlash flash(SECTORS * SECTOR, SECTOR);
+  FlashRingLog log(flash);
+  TEST_ASSERT_TRUE(log.begin());
+  // Wrapped twice, head sector partly filled
+  const uint32_t total = 2 * SECTORS * RPS + 77;
+  appendRange(log, 0, total);
+  TEST_ASSERT_TRUE(flash.saveImage(imagePath));
+
+  HistoryReader reader;
+  TEST_ASSERT_TRUE(reader.open(imagePath, SECTOR));
+  TEST_ASSERT_EQUAL_UINT32(log.count(), reader.count());
+  TEST_ASSERT_EQUAL_UINT32(SECTORS, reader.blockCount());
+  TEST_ASSERT_EQUAL_UINT32(77, reader.block(SECTORS - 1).size);
+
+  // Every record, oldest first, in place in the mapping
+  uint32_t first = total - log.count();
+  uint32_t seen = 0;
+  reader.forEach([&](const LogRecord &rec)
+                 { return rec.timestamp == first + seen++; });
+  TEST_ASSERT_EQUAL_UINT32(reader.count(), seen);
+
+  // spanAt() never crosses a block and starts at the right record
+  uint32_t index = RPS - 3;
+  RecordSpan span = reader.spanAt(index, 10);
+  TEST_ASSERT_EQUAL_UINT32(3, span.size);
+  TEST_ASSERT_EQUAL_UINT32(first + index, span.data[0].timestamp);
+  span = reader.spanAt(index + 3, 10);
+  TEST_ASSERT_EQUAL_UINT32(10, span.size);
+  TEST_ASSERT_EQUAL_UINT32(first + index + 3, span.data[0].timestamp);
+  TEST_ASSERT_TRUE(reader.spanAt(reader.count(), 1).empty());
+
+  // forEachFrom() skips to the block holding the index
+  uint32_t from = 3 * RPS + 5;
+  uint32_t expect = first + from;
+  bool inOrder = true;
+  reader.forEachFrom(from, [&](const LogRecord &rec)
+                     {
+                       inOrder = inOrder && rec.timestamp == expect++;
+                       return true;
+                     });
+  TEST_ASSERT_TRUE(inOrder);
+  TEST_ASSERT_EQUAL_UINT32(first + reader.count(), expect);
+
+  // Contents agree with FlashRingLog::read()
+  LogRecord copy[16];
+  TEST_ASSERT_EQUAL_UINT32(16, log.read(from, copy, 16));
+  span = reader.spanAt(from, 16);
+  TEST_ASSERT_EQUAL_UINT32(16, span.size);
+  TEST_ASSERT_EQUAL_MEMORY(copy, span.data, sizeof(copy));
+}
+
+void test_refresh_sees_new_appends()
+{
+  SimulatedFlash flash(SECTORS * SECTOR, SECTOR);
+  FlashRingLog log(flash);
+  TEST_ASSERT_TRUE(log.begin());
+  appendRange(log, 0, 100);
+  TEST_ASSERT_TRUE(flash.saveImage(imagePath));
+
+  HistoryReader reader;
+  TEST_ASSERT_TRUE(reader.open(imagePath, SECTOR));
+  TEST_ASSERT_EQUAL_UINT32(100, reader.count());
+
+  // The writer moves into the next sector; the mapping follows the file
+  appendRange(log, 100, RPS + 50);
+  TEST_ASSERT_TRUE(flash.saveImage(imagePath));
+  TEST_ASSERT_TRUE(reader.refresh());
+  TEST_ASSERT_EQUAL_UINT32(RPS + 50, reader.count());
+  TEST_ASSERT_EQUAL_UINT32(2, reader.blockCount());
+  RecordSpan last = reader.spanAt(RPS + 49, 1);
+  TEST_ASSERT_EQUAL_UINT32(1, last.size);
+  TEST_ASSERT_EQUAL_UINT32(RPS + 49, last.data[0].timestamp);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_blank_image_is_empty);
+  RUN_TEST(test_missing_image_fails_to_open);
+  RUN_TEST(test_spans_match_the_ring_log);
+  RUN_TEST(test_refresh_sees_new_appends);
+  return UNITY_END();
+}
@@ -0,0 +1,147 @@
+#include <unity.h>
+#include <vector>
+#include "ListWindow.h"
+
+namespace
+{
+  // VirtualList's numbers: a 4096 px window of 24 px rows, a 200 px viewport
+  const int32_t WINDOW_PX = 4096;
+  const int32_t ROW = 24;
+  const uint32_t MAX_ROWS = WINDOW_PX / ROW;
+  const int32_t VIEW_PX = 200;
+  const uint32_t VIEW_ROWS = VIEW_PX / ROW + 1;
+
+  // The list's scroll state as VirtualList::update() keeps it
+  struct Scroll
+  {
+    uint32_t count;
+    uint32_t base;
+    int32_t top; // scroll position inside the window, px
+
+    int32_t windowPx() const { return (int32_t)ListWindow::rows(count, base, MAX_ROWS) * ROW; }
+    // Distance from the first entry, which re-centring must never change
+    uint64_t absolute() const { return (uint64_t)base * ROW + top; }
+
+    // Scroll by dy px as LVGL would (clamped to the window), then re-centre
+    void by(int32_t dy)
+    {
+      top += dy;
+      int32_t limit = windowPx() - VIEW_PX > 0 ? windowPx() - VIEW_PX : 0;
+      top = top < 0 ? 0 : (top > limit ? limit : top);
+      uint32_t newBase = ListWindow::recentre(base, top / ROW, VIEW_ROWS, count, MAX_ROWS);
+      top += ((int32_t)base - (int32_t)newBase) * ROW;
+      base = newBase;
+    }
+  };
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_pool_size()
+{
+  TEST_ASSERT_EQUAL_UINT32(0, ListWindow::poolSize(0, ROW, 24));
+  TEST_ASSERT_EQUAL_UINT32(0, ListWindow::poolSize(-5, ROW, 24));
+  TEST_ASSERT_EQUAL_UINT32(10, ListWindow::poolSize(VIEW_PX, ROW, 24));
+  TEST_ASSERT_EQUAL_UINT32(3, ListWindow::poolSize(ROW, ROW, 24));
+  TEST_ASSERT_EQUAL_UINT32(24, ListWindow::poolSize(2000, ROW, 24));
+}
+
+void test_window_rows_and_centring()
+{
+  TEST_ASSERT_EQUAL_UINT32(50, ListWindow::rows(50, 0, MAX_ROWS));
+  TEST_ASSERT_EQUAL_UINT32(MAX_ROWS, ListWindow::rows(100000, 500, MAX_ROWS));
+  TEST_ASSERT_EQUAL_UINT32(10, ListWindow::rows(100000, 100000 - 10, MAX_ROWS));
+
+  // A short list always starts at 0
+  TEST_ASSERT_EQUAL_UINT32(0, ListWindow::centredBase(40, 50, MAX_ROWS));
+  // Near the front the window starts at 0, further on it is centred
+  TEST_ASSERT_EQUAL_UINT32(0, ListWindow::centredBase(MAX_ROWS / 2, 100000, MAX_ROWS));
+  TEST_ASSERT_EQUAL_UINT32(5000 - MAX_ROWS / 2, ListWindow::centredBase(5000, 100000, MAX_ROWS));
+  // and at the end it is full, not running past the last entry
+  TEST_ASSERT_EQUAL_UINT32(100000 - MAX_ROWS, ListWindow::centredBase(99990, 100000, MAX_ROWS));
+}
+
+void test_recentre_only_near_the_ends()
+{
+  // Fits in one window: never moves
+  TEST_ASSERT_EQUAL_UINT32(0, ListWindow::recentre(0, 150, VIEW_ROWS, MAX_ROWS, MAX_ROWS));
+  // In the middle of a window: stays
+  TEST_ASSERT_EQUAL_UINT32(1000, ListWindow::recentre(1000, MAX_ROWS / 2, VIEW_ROWS, 100000, MAX_ROWS));
+  // At the start of the list nothing is above the window to move to
+  TEST_ASSERT_EQUAL_UINT32(0, ListWindow::recentre(0, 0, VIEW_ROWS, 100000, MAX_ROWS));
+  // Close to either end of the window: the viewport goes back to the middle
+  TEST_ASSERT_EQUAL_UINT32(1002 - MAX_ROWS / 2, ListWindow::recentre(1000, 2, VIEW_ROWS, 100000, MAX_ROWS));
+  uint32_t topRow = MAX_ROWS - VIEW_ROWS;
+  TEST_ASSERT_EQUAL_UINT32(1000 + topRow - MAX_ROWS / 2, ListWindow::recentre(1000, topRow, VIEW_ROWS, 100000, MAX_ROWS));
+  // At the end of the list the window stays full
+  TEST_ASSERT_EQUAL_UINT32(100000 - MAX_ROWS, ListWindow::recentre(100000 - MAX_ROWS, topRow, VIEW_ROWS, 100000, MAX_ROWS));
+}
+
+void test_one_row_of_scrolling_rebinds_one_slot()
+{
+  const uint8_t POOL = 10;
+  std::vector<uint32_t> bound(POOL, UINT32_MAX);
+  for (uint32_t first = 0; first < 1000; first++)
+  {
+    uint32_t rebinds = 0;
+    for (uint32_t k = first; k < first + POOL; k++)
+    {
+      uint8_t slot = ListWindow::slot(k, POOL);
+      if (bound[slot] != k)
+        rebinds++;
+      bound[slot] = k;
+    }
+    // Each row on screen has its own label
+    TEST_ASSERT_EQUAL_UINT32(first ? 1 : POOL, rebinds);
+  }
+}
+
+void test_scrolling_a_long_list_end_to_end()
+{
+  Scroll s = {100000, 0, 0};
+  uint64_t expected = 0;
+  uint32_t recentres = 0;
+  const uint64_t END = (uint64_t)s.count * ROW - VIEW_PX;
+
+  // Down in 16 px steps, then back up in 40 px steps
+  while (s.absolute() < END)
+  {
+    uint32_t base = s.base;
+    s.by(16);
+    expected = expected + 16 < END ? expected + 16 : END;
+    recentres += s.base != base;
+    // Re-centring is invisible: the viewport stays on the same entries
+    TEST_ASSERT_TRUE(expected == s.absolute());
+    // The window fits lv_coord_t and always contains the viewport
+    TEST_ASSERT_TRUE(s.windowPx() <= WINDOW_PX);
+    TEST_ASSERT_TRUE(s.top >= 0 && s.top + VIEW_PX <= s.windowPx());
+  }
+  TEST_ASSERT_EQUAL_UINT32(s.count - MAX_ROWS, s.base);
+  TEST_ASSERT_TRUE(recentres > 100);
+
+  while (s.absolute() > 0)
+  {
+    s.by(-40);
+    expected = expected > 40 ? expected - 40 : 0;
+    TEST_ASSERT_TRUE(expected == s.absolute());
+    TEST_ASSERT_TRUE(s.top >= 0 && s.top + VIEW_PX <= s.windowPx());
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, s.base);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_pool_size);
+  RUN_TEST(test_window_rows_and_centring);
+  RUN_TEST(test_recentre_only_near_the_ends);
+  RUN_TEST(test_one_row_of_scrolling_rebinds_one_slot);
+  RUN_TEST(test_scrolling_a_long_list_end_to_end);
+  return UNITY_END();
+}
@@ -0,0 +1,100 @@
+#include <unity.h>
+#include <stdio.h>
+#include "HostTick.h"
+#include "LvglMemory.h"
+#include "MainInterface.h"
+#include "TemplateCode.h"
+
+/**
+ * Soak test for the LVGL allocator (LvglMemory).
+ *
+ * Rebuilds the main screen once per simulated minute: a new screen, fresh
+ * readings, the old screen deleted and a few frames rendered. Live memory
+ * must come back to the same level after every switch, pool and heap
+ * peaks must stop growing after warm-up, and the heap (the host arena, see
+ * LvglMemory.h) must never get as fragmented as LVGL_MEM_FRAG_WARN.
+ *
+ * The default is one simulated week; for the four-week run build with
+ * -DMEM_SOAK_SWITCHES=40320.
+ */
+
+#ifndef MEM_SOAK_SWITCHES
+#define MEM_SOAK_SWITCHES 10080
+#endif
+
+namespace
+{
+  // Frames rendered per switch; the rest of the simulated minute is skipped
+  const uint32_t RENDER_MS = 100;
+  const uint32_t SWITCH_MS = 60000;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_screen_switches_do_not_creep()
+{
+  TemplateCode &display = TemplateCode::getInstance();
+  TEST_ASSERT_TRUE(display.begin());
+
+  // Two interfaces so the new screen is built before the old one is deleted
+  static MainInterface screens[2];
+  const uint32_t switches = MEM_SOAK_SWITCHES < 20 ? 20 : MEM_SOAK_SWITCHES;
+  const uint32_t warmup = switches < 1000 ? switches / 10 : 100;
+  uint32_t baselineLive = 0;
+  uint32_t midPeak = 0;
+  uint8_t worstFragmentation = 0;
+
+  for (uint32_t i = 0; i < switches; i++)
+  {
+    lv_obj_t *previous = lv_scr_act();
+    MainInterface &ui = screens[i & 1];
+    ui.init();
+    lv_obj_del(previous);
+    ui.setTemperature(-40.0f + (i % 1650) * 0.1f);
+    ui.setHumidity((i % 1001) * 0.1f);
+    display.advance(RENDER_MS);
+    display.waitForFlush();
+    hostTickAdvance(SWITCH_MS - RENDER_MS);
+
+    const LvglMemStats &s = LvglMemory::stats();
+    if (i + 1 == warmup)
+    {
+      // From here on every switch should leave memory exactly where it was
+      baselineLive = s.liveBytes;
+      LvglMemory::resetPeaks();
+    }
+    else if (i + 1 > warmup)
+    {
+      TEST_ASSERT_LESS_OR_EQUAL_UINT32(baselineLive, s.liveBytes);
+    }
+    if (i + 1 == warmup + (switches - warmup) / 2)
+      midPeak = s.peakBytes;
+    uint8_t fragmentation = LvglMemory::heapFragmentation();
+    if (fragmentation > worstFragmentation)
+      worstFragmentation = fragmentation;
+  }
+
+  const LvglMemStats &s = LvglMemory::stats();
+  char message[160];
+  snprintf(message, sizeof(message),
+           "%lu switches: live %lu B after warm-up, peak %lu B mid-run, %lu B at end, heap fragmentation up to %u%%",
+           (unsigned long)switches, (unsigned long)baselineLive, (unsigned long)midPeak,
+           (unsigned long)s.peakBytes, (unsigned)worstFragmentation);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(midPeak, s.peakBytes);
+  TEST_ASSERT_LESS_THAN_UINT8(LVGL_MEM_FRAG_WARN, worstFragmentation);
+  TEST_ASSERT_EQUAL_UINT32(0, s.failures);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_screen_switches_do_not_creep);
+  return UNITY_END();
+}
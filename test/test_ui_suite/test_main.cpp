@@ -0,0 +1,40 @@
+#include <unity.h>
+#include "TemplateCode.h"
+#include "UiSuite.h"
+
+/**
+ * The rendering regression suite (UiSuite) against the checked-in baseline.
+ * Record a new baseline with `program --suite test/ui-golden --update`.
+ */
+
+// pio test runs from the project directory
+#ifndef UI_GOLDEN_DIR
+#define UI_GOLDEN_DIR "test/ui-golden"
+#endif
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_ui_matches_the_baseline()
+{
+  TemplateCode &display = TemplateCode::getInstance();
+  TEST_ASSERT_TRUE(display.begin());
+  UiSuite suite(display, UI_GOLDEN_DIR);
+  // Without costs.txt every scenario would fail; say what is missing instead.
+  // Once a baseline is recorded, a missing frame or scenario line fails.
+  if (!suite.hasBaseline())
+    TEST_IGNORE_MESSAGE("no baseline recorded in " UI_GOLDEN_DIR " (run program --suite " UI_GOLDEN_DIR " --update)");
+  TEST_ASSERT_EQUAL_INT_MESSAGE(0, suite.run(false), "scenarios failed, see the report above");
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_ui_matches_the_baseline);
+  return UNITY_END();
+}